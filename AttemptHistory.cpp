@@ -0,0 +1,136 @@
+#include "AttemptHistory.h"
+#include "Crc32c.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr uint8_t FRAME_MARKER[2] = { 'C', 'H' };
+    constexpr size_t MAX_VARINT_BYTES = 10;
+
+    void PutVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // Returns false if the varint runs past `end` or is longer than 64 bits.
+    bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            uint8_t byte = *p++;
+            value |= uint64_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    uint64_t ZigZag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t UnZigZag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    bool DecodePayload(const uint8_t* p, const uint8_t* end, const std::function<void(const AttemptHistory::AttemptRecord&)>& visit, size_t& records)
+    {
+        uint64_t timestamp = 0;
+        uint64_t count = 0;
+        if (!GetVarint(p, end, timestamp) || !GetVarint(p, end, count)) return false;
+
+        AttemptHistory::AttemptRecord record;
+        record.timestamp_ms = static_cast<int64_t>(timestamp);
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t shot = 0, delta = 0, boost = 0, duration = 0;
+            if (!GetVarint(p, end, shot) || !GetVarint(p, end, delta) || !GetVarint(p, end, boost) || !GetVarint(p, end, duration)) {
+                return false;
+            }
+            record.shot_index = static_cast<int>(shot);
+            record.timestamp_ms += UnZigZag(delta >> 1);
+            record.success = (delta & 1) != 0;
+            record.boost_used = static_cast<float>(boost) / 100.0f;
+            record.duration_ms = static_cast<uint32_t>(duration);
+            visit(record);
+            records++;
+        }
+        return p == end;
+    }
+}
+
+namespace AttemptHistory
+{
+    std::string EncodeFrame(const std::vector<AttemptRecord>& records)
+    {
+        std::string payload;
+        payload.reserve(2 * MAX_VARINT_BYTES + records.size() * 8);
+
+        int64_t previous = records.empty() ? 0 : records.front().timestamp_ms;
+        PutVarint(payload, static_cast<uint64_t>(previous));
+        PutVarint(payload, records.size());
+        for (const AttemptRecord& record : records) {
+            PutVarint(payload, static_cast<uint64_t>(record.shot_index < 0 ? 0 : record.shot_index));
+            PutVarint(payload, (ZigZag(record.timestamp_ms - previous) << 1) | (record.success ? 1u : 0u));
+            PutVarint(payload, static_cast<uint64_t>(std::lround(record.boost_used > 0.0f ? record.boost_used * 100.0f : 0.0f)));
+            PutVarint(payload, record.duration_ms);
+            previous = record.timestamp_ms;
+        }
+
+        std::string frame;
+        frame.reserve(sizeof(FRAME_MARKER) + MAX_VARINT_BYTES + sizeof(uint32_t) + payload.size());
+        frame.append(reinterpret_cast<const char*>(FRAME_MARKER), sizeof(FRAME_MARKER));
+        PutVarint(frame, payload.size());
+        uint32_t crc = Crc32c(payload.data(), payload.size());
+        char crc_bytes[sizeof(crc)];
+        std::memcpy(crc_bytes, &crc, sizeof(crc));
+        frame.append(crc_bytes, sizeof(crc));
+        frame += payload;
+        return frame;
+    }
+
+    void Decode(const uint8_t* data, size_t size, const std::function<void(const AttemptRecord&)>& visit, DecodeReport* report)
+    {
+        DecodeReport local;
+        DecodeReport& r = report ? *report : local;
+        r = DecodeReport();
+
+        const uint8_t* p = data;
+        const uint8_t* end = data + size;
+        while (p < end) {
+            const uint8_t* frame = p;
+            uint64_t length = 0;
+            uint32_t crc = 0;
+            bool valid = end - p >= 2 && p[0] == FRAME_MARKER[0] && p[1] == FRAME_MARKER[1];
+            if (valid) {
+                p += 2;
+                valid = GetVarint(p, end, length) && size_t(end - p) >= sizeof(crc) && length <= size_t(end - p) - sizeof(crc);
+            }
+            if (valid) {
+                std::memcpy(&crc, p, sizeof(crc));
+                p += sizeof(crc);
+                valid = Crc32c(p, static_cast<size_t>(length)) == crc;
+            }
+
+            // Records are only handed out once the frame's checksum has matched, so they are never half-read.
+            size_t records = 0;
+            if (valid && DecodePayload(p, p + length, visit, records)) {
+                p += length;
+                r.frames++;
+                r.records += records;
+                continue;
+            }
+
+            // Resynchronize on the next frame marker.
+            p = frame + 1;
+            while (p < end && *p != FRAME_MARKER[0]) ++p;
+            r.skipped_bytes += static_cast<size_t>(p - frame);
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Compact append-only log of every attempt, one file per training pack (<n>.hist next to the pack's shard).
+//
+// The file is a sequence of self-contained frames, appended as attempts are recorded and never rewritten:
+//   Frame    u8 'C', u8 'H', varint payload length, u32 CRC-32C of the payload, payload
+//   Payload  varint base timestamp (ms since the Unix epoch), varint record count, records
+//   Record   varint shot index, varint (zigzag timestamp delta from the previous record << 1 | success),
+//            varint boost used (hundredths of a boost unit), varint attempt duration (ms)
+//
+// A typical attempt takes about 8 bytes. A torn or corrupt frame is skipped by scanning for the next frame
+// marker, so a crash mid-append only loses that frame.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace AttemptHistory
+{
+    struct AttemptRecord
+    {
+        int shot_index = 0;
+        int64_t timestamp_ms = 0;
+        bool success = false;
+        float boost_used = 0.0f;
+        uint32_t duration_ms = 0;
+    };
+
+    struct DecodeReport
+    {
+        size_t frames = 0;
+        size_t records = 0;
+        size_t skipped_bytes = 0; // Bytes that did not belong to a valid frame (torn writes, corruption)
+    };
+
+    // Encodes `records` (in the order they happened) as one frame ready to be appended to the file.
+    std::string EncodeFrame(const std::vector<AttemptRecord>& records);
+
+    // Calls `visit` for every record in the valid frames of `data`, in file order, without keeping them.
+    void Decode(const uint8_t* data, size_t size, const std::function<void(const AttemptRecord&)>& visit, DecodeReport* report = nullptr);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ShotStats.h"
+
+// Boost used over one attempt, measured from the car's boost amount at a few points instead of per input tick.
+// Amounts are in boost units (0-100). Every decrease between two readings is counted as use; refills are bracketed
+// by BeforeRefill/AfterRefill so the amount they add is not mistaken for negative use.
+class BoostDeltaMeter
+{
+public:
+    void Start(float amount)
+    {
+        last_amount_ = amount;
+        used_ = 0.0;
+        active_ = true;
+    }
+
+    bool IsActive() const { return active_; }
+
+    // Any reading outside a refill. Returns false if the amount rose, i.e. a refill went unseen and the
+    // decreases so far no longer add up to what was used; the caller should fall back to counting ticks.
+    bool Sample(float amount)
+    {
+        if (!active_) return true;
+        if (amount > last_amount_ + RISE_TOLERANCE) return false;
+        if (amount < last_amount_) used_ += last_amount_ - amount;
+        last_amount_ = amount;
+        return true;
+    }
+
+    bool BeforeRefill(float amount) { return Sample(amount); }
+    void AfterRefill(float amount)
+    {
+        if (active_) last_amount_ = amount;
+    }
+
+    // Ends the measurement and returns what was used so far, in ticks so it adds straight onto the tick counter.
+    BoostTicks Stop()
+    {
+        BoostTicks ticks = active_ ? BoostAmountToTicks(used_) : 0;
+        active_ = false;
+        used_ = 0.0;
+        return ticks;
+    }
+
+private:
+    // The component stores boost as a float fraction, so identical readings can differ in the last bits.
+    static constexpr float RISE_TOLERANCE = 0.01f;
+
+    float last_amount_ = 0.0f;
+    double used_ = 0.0;
+    bool active_ = false;
+};
@@ -1,93 +1,21 @@
 #include "pch.h"
 #include "ConsistencyTrainer.h"
+#include "StatsTextFormat.h"
+#include "StatsBinaryFormat.h"
+#include "MappedFile.h"
+#include "PackShardStore.h"
 #include "imgui/imgui.h"
+#include "imgui/imguivariouscontrols.h"
 #include <limits>
 #include <sstream>
 #include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <filesystem>
 
 // Type definitions to resolve E0020
-using PackStats = std::map<int, ShotStats>;
-using PersistentData = std::map<std::string, PackStats>;
-
-std::string SerializeStats(const PersistentData& data) {
-    std::stringstream ss;
-    for (const auto& pack_pair : data) {
-        for (const auto& shot_pair : pack_pair.second) {
-            ss << pack_pair.first << "|"
-                << shot_pair.first << "|"
-                << shot_pair.second.lifetime_best_successes << "|"
-                << shot_pair.second.lifetime_attempts_at_best << "|"
-                << std::to_string(shot_pair.second.lifetime_total_boost_at_best) << "|"
-                << std::to_string(shot_pair.second.lifetime_total_successful_boost_at_best) << "|"
-                << std::to_string(shot_pair.second.lifetime_min_boost)
-                << ";";
-        }
-    }
-    std::string result = ss.str();
-    if (!result.empty()) {
-        result.pop_back();
-    }
-    return result;
-}
-
-PersistentData DeserializeStats(const std::string& str) {
-    PersistentData data;
-    if (str.empty()) return data;
-
-    std::stringstream ss(str);
-    std::string record;
-
-    while (std::getline(ss, record, ';')) {
-        std::stringstream rs(record);
-        std::string segment;
-        std::vector<std::string> segments;
-
-        while (std::getline(rs, segment, '|')) {
-            segments.push_back(segment);
-        }
-
-        if (segments.size() == 7) {
-            std::string pack_id = segments[0];
-            int shot_index = std::stoi(segments[1]);
-            ShotStats s;
-            s.lifetime_best_successes = std::stoi(segments[2]);
-            s.lifetime_attempts_at_best = std::stoi(segments[3]);
-            s.lifetime_total_boost_at_best = std::stod(segments[4]);
-            s.lifetime_total_successful_boost_at_best = std::stod(segments[5]);
-            s.lifetime_min_boost = std::stod(segments[6]);
-
-            s.attempts = 0; s.successes = 0; s.total_boost_used = 0.0;
-            s.total_successful_boost_used = 0.0;
-            s.min_successful_boost_used = std::numeric_limits<double>::max();
-
-            data[pack_id][shot_index] = s;
-        }
-        else if (segments.size() == 6) {
-            std::string pack_id = segments[0];
-            int shot_index = std::stoi(segments[1]);
-            ShotStats s;
-            s.lifetime_best_successes = std::stoi(segments[2]);
-            s.lifetime_attempts_at_best = 10;
-            s.lifetime_total_boost_at_best = std::stod(segments[3]);
-            s.lifetime_total_successful_boost_at_best = std::stod(segments[4]);
-            s.lifetime_min_boost = std::stod(segments[5]);
-
-            s.attempts = 0; s.successes = 0; s.total_boost_used = 0.0;
-            s.total_successful_boost_used = 0.0;
-            s.min_successful_boost_used = std::numeric_limits<double>::max();
-
-            if (_globalCvarManager) {
-                _globalCvarManager->log("Deserialized legacy 6-segment data. Assuming lifetime_attempts_at_best = 10.");
-            }
-
-            data[pack_id][shot_index] = s;
-        }
-    }
-    return data;
-}
+using PackStats = ShotPackStats;
 
 BAKKESMOD_PLUGIN(ConsistencyTrainer, "Consistency Trainer", "1.0.0", PLUGINTYPE_CUSTOM_TRAINING)
 
@@ -97,17 +25,34 @@ struct PlaylistIndexParams {
     int Index;
 };
 
+static const char* const VEHICLE_INPUT_EVENT = "Function TAGame.Car_TA.SetVehicleInput";
+static const char* const GIVE_BOOST_EVENT = "Function TAGame.CarComponent_Boost_TA.GiveBoost2";
+
 void ConsistencyTrainer::onLoad()
 {
     _globalCvarManager = cvarManager;
+    cvarManager->registerCvar("ct_log_level", "1", "Console log level: 0 = debug, 1 = info, 2 = warnings, 3 = errors, 4 = off", true, true, 0, true, 4)
+        .addOnValueChanged([](std::string, CVarWrapper cvar) { SetLogLevel(static_cast<LogLevel>(cvar.getIntValue())); });
+    SetLogLevel(static_cast<LogLevel>(cvarManager->getCvar("ct_log_level").getIntValue()));
 
     dataFilePath_ = gameWrapper->GetBakkesModPath().string() + "\\data\\ConsistencyTrainer.data";
-    cvarManager->log("Persistence file path set to: " + dataFilePath_);
+    binaryFilePath_ = gameWrapper->GetBakkesModPath().string() + "\\data\\ConsistencyTrainer.bin";
+    journalFilePath_ = gameWrapper->GetBakkesModPath().string() + "\\data\\ConsistencyTrainer.journal";
+    shardDirectory_ = gameWrapper->GetBakkesModPath().string() + "\\data\\ConsistencyTrainer";
+    LOG("Persistence directory set to: {}", shardDirectory_);
+    shard_store_ = std::make_unique<PackShardStore>(shardDirectory_, SNAPSHOT_GENERATIONS);
+    persistence_writer_ = std::make_unique<PersistenceWriter>(journalFilePath_, SNAPSHOT_GENERATIONS);
 
     cvarManager->registerCvar("ct_plugin_enabled", "0", "Enable/Disable the Consistency Trainer plugin")
-        .addOnValueChanged([this](std::string, CVarWrapper cvar) { is_plugin_enabled_ = cvar.getBoolValue(); });
+        .addOnValueChanged([this](std::string, CVarWrapper cvar) {
+            is_plugin_enabled_ = cvar.getBoolValue();
+            UpdateVehicleInputHook(IsInValidTraining());
+        });
     cvarManager->registerCvar("ct_max_attempts", "10", "Max attempts per shot for consistency tracking")
-        .addOnValueChanged([this](std::string, CVarWrapper cvar) { max_attempts_per_shot_ = cvar.getIntValue(); });
+        .addOnValueChanged([this](std::string, CVarWrapper cvar) {
+            core_.SetMaxAttemptsPerShot(cvar.getIntValue());
+            UpdateAttemptArmed();
+        });
     cvarManager->registerCvar("ct_text_x", "100", "X position of the stats text")
         .addOnValueChanged([this](std::string, CVarWrapper cvar) { text_pos_x_ = cvar.getIntValue(); });
     cvarManager->registerCvar("ct_text_y", "200", "Y position of the stats text")
@@ -120,52 +65,225 @@ void ConsistencyTrainer::onLoad()
         .addOnValueChanged([this](std::string, CVarWrapper cvar) { show_consistency_stats_ = cvar.getBoolValue(); });
     cvarManager->registerCvar("ct_show_boost", "0", "Show boost usage stats")
         .addOnValueChanged([this](std::string, CVarWrapper cvar) { show_boost_stats_ = cvar.getBoolValue(); });
+    cvarManager->registerCvar("ct_boost_mode", "0", "Boost measurement: 0 = count boosting input ticks, 1 = boost amount decreases between attempt events", true, true, 0, true, 1)
+        .addOnValueChanged([this](std::string, CVarWrapper cvar) { SetBoostMeasureMode(cvar.getIntValue() == 1 ? BoostMeasureMode::Deltas : BoostMeasureMode::Ticks); });
 
     is_plugin_enabled_ = cvarManager->getCvar("ct_plugin_enabled").getBoolValue();
-    max_attempts_per_shot_ = cvarManager->getCvar("ct_max_attempts").getIntValue();
+    core_.SetMaxAttemptsPerShot(cvarManager->getCvar("ct_max_attempts").getIntValue());
     text_pos_x_ = cvarManager->getCvar("ct_text_x").getIntValue();
     text_pos_y_ = cvarManager->getCvar("ct_text_y").getIntValue();
     text_scale_ = cvarManager->getCvar("ct_text_scale").getFloatValue();
     is_window_open_ = cvarManager->getCvar("ct_window_open").getBoolValue();
     show_consistency_stats_ = cvarManager->getCvar("ct_show_consistency").getBoolValue();
     show_boost_stats_ = cvarManager->getCvar("ct_show_boost").getBoolValue();
+    boost_mode_ = cvarManager->getCvar("ct_boost_mode").getIntValue() == 1 ? BoostMeasureMode::Deltas : BoostMeasureMode::Ticks;
 
     LoadPersistentStats();
 
+    // Game hooks only record the event; ProcessGameEvents applies them in order once per frame. Attempt starts and
+    // outcomes take their boost reading here, so it matches the moment the game fired them.
     gameWrapper->HookEvent("Function TAGame.GameMetrics_TA.GoalScored",
-        [this](...) { OnGoalScored(nullptr); });
+        [this](...) { SettleBoostMeasurement(); PushGameEvent(GameEvent::Type::GoalScored); });
 
     gameWrapper->HookEventWithCallerPost<ActorWrapper>("Function TAGame.GameEvent_TrainingEditor_TA.OnResetShot",
-        std::bind(&ConsistencyTrainer::OnShotReset, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        [this](ActorWrapper, void*, std::string) {
+            // The reset RepeatCurrentShot causes can fire after the next attempt started; it must not end that measurement.
+            if (!core_.ExpectsSelfReset()) SettleBoostMeasurement();
+            PushGameEvent(GameEvent::Type::ShotReset);
+        });
 
     gameWrapper->HookEvent("Function TAGame.GameEvent_TrainingEditor_TA.OnBallExploded",
-        [this](...) { OnBallExploded(nullptr); });
+        [this](...) { SettleBoostMeasurement(); PushGameEvent(GameEvent::Type::BallExploded); });
 
     gameWrapper->HookEventWithCallerPost<ActorWrapper>("Function TAGame.TrainingEditorNavigation_TA.SetCurrentActivePlaylistIndex",
-        std::bind(&ConsistencyTrainer::OnPlaylistIndexChanged, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        [this](ActorWrapper, void* params, std::string) {
+            if (params == nullptr) return;
+            PushGameEvent(GameEvent::Type::PlaylistIndexChanged, static_cast<PlaylistIndexParams*>(params)->Index);
+        });
 
-    gameWrapper->HookEvent("Function TAGame.GameEvent_TrainingEditor_TA.StartPlayTest", [this](...) { InitializeSessionStats(); });
+    gameWrapper->HookEvent("Function TAGame.GameEvent_TrainingEditor_TA.StartPlayTest",
+        [this](...) { PushGameEvent(GameEvent::Type::SessionStarted); });
 
     gameWrapper->HookEvent("Function TAGame.TrainingEditorMetrics_TA.TrainingShotAttempt",
-        [this](...) { OnShotAttempt(nullptr); });
+        [this](...) { StartBoostMeasurement(); PushGameEvent(GameEvent::Type::ShotAttempt); });
 
-    gameWrapper->HookEvent("Function TAGame.Car_TA.SetVehicleInput", [this](std::string eventName) { OnSetVehicleInput(eventName); });
+    // SetVehicleInput itself is only hooked while a session is live (UpdateVehicleInputHook); this takes it down on leaving.
+    gameWrapper->HookEvent("Function TAGame.GameEvent_Soccar_TA.Destroyed", [this](...) { UpdateVehicleInputHook(false); });
 
+    // Boost-delta mode brackets every refill, so the amount it adds is not read as negative use.
+    gameWrapper->HookEventWithCaller<ActorWrapper>(GIVE_BOOST_EVENT,
+        [this](ActorWrapper caller, void*, std::string) { OnBoostRefill(caller, true); });
+    gameWrapper->HookEventWithCallerPost<ActorWrapper>(GIVE_BOOST_EVENT,
+        [this](ActorWrapper caller, void*, std::string) { OnBoostRefill(caller, false); });
 
     gameWrapper->RegisterDrawable(std::bind(&ConsistencyTrainer::RenderWindow, this, std::placeholders::_1));
     cvarManager->registerNotifier("toggle_consistency_trainer", [this](...) {
         cvarManager->getCvar("ct_window_open").setValue(!is_window_open_);
     }, "Toggle the Consistency Trainer window", PERMISSION_ALL);
+    cvarManager->registerNotifier("ct_history", [this](...) {
+        LogAttemptHistory();
+        DrainLog();
+    }, "Log per-shot totals from the current pack's attempt history", PERMISSION_ALL);
+    cvarManager->registerNotifier("ct_hook_stats", [this](...) {
+        LOG("SetVehicleInput: hooked={}, installs={}, calls={}, calls outside training={}.",
+            vehicle_input_hooked_, vehicle_input_hook_installs_, vehicle_input_calls_, vehicle_input_calls_outside_training_);
+        LOG("Event queue: processed={}, dropped={}. Outcomes ignored after settling={}, own shot resets absorbed={}, outcome to next attempt ms last={:.3f} max={:.3f}.",
+            game_events_processed_, game_events_.DroppedCount(), core_.DuplicateOutcomes(), core_.SelfResets(),
+            std::chrono::duration<double, std::milli>(core_.LastOutcomeToAttempt()).count(),
+            std::chrono::duration<double, std::milli>(core_.MaxOutcomeToAttempt()).count());
+        LOG("Log queue: dropped={}, truncated={}.", g_log_ring.DroppedCount(), g_log_ring.TruncatedCount());
+        LOG("Saves: last re-encoded {} of {} record bytes, {} bytes re-encoded since load.",
+            last_save_encoded_bytes_, last_save_record_bytes_, total_encoded_bytes_);
+        DrainLog();
+    }, "Log hook, event queue, log queue and save counters", PERMISSION_ALL);
+#if CT_PERF_STATS
+    cvarManager->registerNotifier("ct_perf_dump", [this](std::vector<std::string> args) {
+        LogPerfCounters();
+        if (args.size() > 1 && args[1] == "reset") {
+            perf_.Reset();
+            LOG("Perf counters reset.");
+        }
+        DrainLog();
+    }, "Log call counts and p50/p99/max latency per hook handler; 'ct_perf_dump reset' also clears them", PERMISSION_ALL);
+#endif
+
+    DrainLog();
 }
 
 void ConsistencyTrainer::onUnload() {
-    if (!training_session_stats_.empty() && !current_pack_id_.empty()) {
-        global_pack_stats_[current_pack_id_] = training_session_stats_;
+    ProcessGameEvents();
+    if (!core_.Stats().empty() && current_pack_ != INVALID_PACK_ID) {
+        CommitShot(core_.CurrentShot());
     }
+    FlushAttemptHistory();
     SavePersistentStats();
 
+    // Make sure the final snapshot is on disk before the plugin goes away.
+    if (persistence_writer_) {
+        if (!persistence_writer_->Flush()) {
+            LOG(LogLevel::Error, "Error: Final save on unload did not complete.");
+        }
+        persistence_writer_->Stop();
+        LogWriterMessages();
+        persistence_writer_.reset();
+    }
+
     gameWrapper->UnregisterDrawables();
-    gameWrapper->UnhookEvent("Function TAGame.Car_TA.SetVehicleInput");
+    UpdateVehicleInputHook(false);
+    gameWrapper->UnhookEvent("Function TAGame.GameEvent_Soccar_TA.Destroyed");
+    gameWrapper->UnhookEvent(GIVE_BOOST_EVENT);
+    gameWrapper->UnhookEventPost(GIVE_BOOST_EVENT);
+    DrainLog();
+}
+
+void ConsistencyTrainer::UpdateVehicleInputHook(bool in_training) {
+    vehicle_input_unhook_pending_ = false;
+    // In boost-delta mode the per-tick hook is only needed while an attempt has fallen back to counting ticks.
+    bool wanted = in_training && is_plugin_enabled_ && !core_.Stats().empty()
+        && (boost_mode_ == BoostMeasureMode::Ticks || boost_tick_fallback_);
+    if (wanted != vehicle_input_hooked_) {
+        if (wanted) {
+            gameWrapper->HookEvent(VEHICLE_INPUT_EVENT, [this](std::string eventName) { OnSetVehicleInput(eventName); });
+            vehicle_input_hook_installs_++;
+        }
+        else {
+            gameWrapper->UnhookEvent(VEHICLE_INPUT_EVENT);
+        }
+        vehicle_input_hooked_ = wanted;
+    }
+    UpdateAttemptArmed();
+}
+
+void ConsistencyTrainer::UpdateAttemptArmed() {
+    // The hook is only installed while enabled, in training and with a session, so those are implied. Ticks count
+    // between attempts too: the core only uses the difference between an attempt's start and outcome readings.
+    attempt_armed_ = vehicle_input_hooked_;
+    if (attempt_armed_) {
+        armed_car_ = gameWrapper->GetLocalCar();
+        attempt_armed_ = !armed_car_.IsNull();
+    }
+    if (!attempt_armed_) {
+        armed_car_ = CarWrapper(0);
+    }
+}
+
+void ConsistencyTrainer::SetBoostMeasureMode(BoostMeasureMode mode) {
+    if (mode == boost_mode_) return;
+
+    // The live attempt keeps what it measured so far and finishes on ticks; the new mode starts with the next attempt.
+    boost_total_ += boost_meter_.Stop();
+    boost_tick_fallback_ = mode == BoostMeasureMode::Deltas;
+    boost_mode_ = mode;
+    UpdateVehicleInputHook(IsInValidTraining());
+}
+
+bool ConsistencyTrainer::ReadBoostAmount(float& amount, std::uintptr_t& component) {
+    CarWrapper car = gameWrapper->GetLocalCar();
+    if (car.IsNull()) return false;
+
+    BoostWrapper boost = car.GetBoostComponent();
+    // With unlimited boost the amount never drops, so only ticks can tell how much was used.
+    if (boost.IsNull() || boost.GetUnlimitedBoostRefCount() > 0) return false;
+
+    amount = boost.GetCurrentBoostAmount() * 100.0f;
+    component = boost.memory_address;
+    return true;
+}
+
+void ConsistencyTrainer::StartBoostMeasurement() {
+    // Whatever was used since the last outcome belongs to no attempt.
+    boost_meter_.Stop();
+    if (boost_mode_ != BoostMeasureMode::Deltas) return;
+
+    float amount = 0.0f;
+    std::uintptr_t component = 0;
+    const bool fallback = !ReadBoostAmount(amount, component);
+    if (!fallback) {
+        boost_meter_.Start(amount);
+    }
+    // The per-tick hook has to be (un)installed now, not when the attempt is applied, or the first frame is lost.
+    if (fallback != boost_tick_fallback_) {
+        boost_tick_fallback_ = fallback;
+        UpdateVehicleInputHook(IsInValidTraining());
+    }
+}
+
+void ConsistencyTrainer::OnBoostRefill(ActorWrapper caller, bool before) {
+    if (!boost_meter_.IsActive()) return;
+
+    float amount = 0.0f;
+    std::uintptr_t component = 0;
+    if (!ReadBoostAmount(amount, component)) {
+        FallBackToBoostTicks();
+        return;
+    }
+    if (caller.memory_address != component) return;
+
+    if (!before) {
+        boost_meter_.AfterRefill(amount);
+    }
+    else if (!boost_meter_.BeforeRefill(amount)) {
+        FallBackToBoostTicks();
+    }
+}
+
+void ConsistencyTrainer::FallBackToBoostTicks() {
+    boost_total_ += boost_meter_.Stop();
+    boost_tick_fallback_ = true;
+    LOG(LogLevel::Warning, "Boost amount changed without a tracked refill. Counting boost ticks for the rest of this attempt.");
+    UpdateVehicleInputHook(IsInValidTraining());
+}
+
+void ConsistencyTrainer::SettleBoostMeasurement() {
+    // Only the first outcome after an attempt start finds the meter running.
+    if (!boost_meter_.IsActive()) return;
+
+    float amount = 0.0f;
+    std::uintptr_t component = 0;
+    if (!ReadBoostAmount(amount, component) || !boost_meter_.Sample(amount)) {
+        LOG(LogLevel::Warning, "Boost amount unreadable or refilled untracked at the outcome. Boost for this attempt is a lower bound.");
+    }
+    boost_total_ += boost_meter_.Stop();
 }
 
 std::string ConsistencyTrainer::GetCurrentPackID() {
@@ -190,403 +308,522 @@ int ConsistencyTrainer::GetTotalRounds() {
     return 0;
 }
 
+static bool ReadWholeFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+void ConsistencyTrainer::LogParseReport(const std::string& source, const StatsParseReport& report) {
+    if (report.legacy_records > 0) {
+        LOG("Deserialized {} legacy 6-segment records from {}. Assuming lifetime_attempts_at_best = 10.", report.legacy_records, source);
+    }
+    if (report.malformed_records > 0) {
+        LOG(LogLevel::Warning, "Skipped {} malformed records in {} (first: {}).", report.malformed_records, source, report.first_error);
+    }
+}
+
 void ConsistencyTrainer::LoadPersistentStats() {
 
-    std::ifstream file(dataFilePath_);
-    std::string storage_str;
+    global_pack_stats_.clear();
+    dirty_packs_.clear();
+    journal_bytes_ = 0;
 
-    if (file.is_open()) {
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        storage_str = buffer.str();
-        file.close();
-        cvarManager->log("Persistence file successfully opened and read.");
+    std::string warning;
+    bool migrating = false;
+    if (shard_store_->LoadIndex(warning)) {
+        if (!warning.empty()) {
+            LOG(LogLevel::Warning, "Shard index: {}", warning);
+        }
+        // Shards themselves are only read when a pack is opened (EnsurePackLoaded).
+        LOG("Shard index lists {} packs. Pack stats load on first use.", shard_store_->GetPackCount());
     }
     else {
-        global_pack_stats_.clear();
-        cvarManager->log("Persistence file does not exist or could not be opened. Starting fresh.");
-        return;
+        if (!warning.empty()) {
+            LOG(LogLevel::Error, "Shard index: {}. Pack names for existing shards are lost.", warning);
+        }
+        // No index yet: pick up the single-file formats and split them into shards below.
+        PersistentData legacy;
+        LoadMonolithicStats(legacy);
+        for (auto& pack_pair : legacy) {
+            PackId id = shard_store_->Intern(pack_pair.first);
+            EnsurePackLoaded(id) = std::move(pack_pair.second);
+            MarkPackDirty(id);
+        }
+        if (!dirty_packs_.empty()) {
+            LOG("Migrating {} packs to per-pack shard files.", dirty_packs_.size());
+            migrating = true;
+        }
     }
 
-    if (storage_str.empty()) {
-        global_pack_stats_.clear();
-        cvarManager->log("Persistence file was empty.");
-        return;
+    // Replay attempts recorded since the last snapshot. A torn final entry (no trailing ';') is ignored.
+    std::string journal_str;
+    ReadWholeFile(journalFilePath_, journal_str);
+
+    int replayed = 0;
+    StatsParseReport report;
+    PersistentData journal = DeserializeJournal(journal_str, &report);
+    LogParseReport("journal", report);
+    for (const auto& pack_pair : journal) {
+        PackId id = shard_store_->Intern(pack_pair.first);
+        ShotPackStats& pack = EnsurePackLoaded(id);
+        for (const auto& shot_pair : pack_pair.second) {
+            pack[shot_pair.first] = shot_pair.second;
+            MarkShotDirty(id, shot_pair.first);
+            replayed++;
+        }
     }
 
-    try {
-        global_pack_stats_ = DeserializeStats(storage_str);
-        cvarManager->log("Loaded persistent stats for " + std::to_string(global_pack_stats_.size()) + " packs from file.");
+    if (replayed > 0) {
+        LOG("Replayed {} journal entries. Compacting.", replayed);
     }
-    catch (const std::exception& e) {
-        cvarManager->log("Error deserializing persistent data from file. Resetting stats. Error: " + std::string(e.what()));
-        global_pack_stats_.clear();
+
+    if (!dirty_packs_.empty()) {
+        SavePersistentStats();
+        // Packs are re-read from their shards on demand, so the compacted shards must be on disk first.
+        const bool saved = persistence_writer_->Flush();
+        LogWriterMessages();
+        if (migrating && saved) {
+            RetireMonolithicFiles();
+        }
     }
+
+    // Nothing needs to stay resident until a pack is opened.
+    global_pack_stats_.clear();
+    shard_store_->ForgetEncodings();
 }
 
-void ConsistencyTrainer::SavePersistentStats() {
-    if (global_pack_stats_.empty()) {
-        cvarManager->log("No data to save. Skipping file write.");
-        return;
+bool ConsistencyTrainer::CommitShot(int shot_index) {
+    if (current_pack_ == INVALID_PACK_ID) return false;
+
+    // The session's lifetime block already is the pack's entry in global_pack_stats_; only the dirty mark is left.
+    if (!core_.Stats().TakeLifetimeChanged(shot_index)) return false;
+
+    MarkShotDirty(current_pack_, shot_index);
+    return true;
+}
+
+void ConsistencyTrainer::MarkShotDirty(PackId pack, int shot_index) {
+    PackDirtyState& dirty = dirty_packs_[pack];
+    if (!dirty.all_shots) {
+        dirty.shots.insert(shot_index);
     }
+}
 
-    try {
-        std::string serialized_data = SerializeStats(global_pack_stats_);
+void ConsistencyTrainer::MarkPackDirty(PackId pack) {
+    PackDirtyState& dirty = dirty_packs_[pack];
+    dirty.all_shots = true;
+    dirty.shots.clear();
+}
 
-        std::ofstream file(dataFilePath_, std::ios::trunc);
-        if (file.is_open()) {
-            file << serialized_data;
-            file.close();
-            cvarManager->log("Saved persistent stats to dedicated file.");
-        }
-        else {
-            cvarManager->log("Error: Could not open persistence file for writing.");
+ShotPackStats& ConsistencyTrainer::EnsurePackLoaded(PackId id) {
+    auto it = global_pack_stats_.find(id);
+    if (it != global_pack_stats_.end()) {
+        return *it->second;
+    }
+
+    std::unique_ptr<ShotPackStats>& slot = global_pack_stats_[id];
+    slot = std::make_unique<ShotPackStats>();
+    ShotPackStats& pack = *slot;
+    const std::string& pack_name = shard_store_->GetName(id);
+    std::string error;
+    int generation = 0;
+    if (shard_store_->LoadShard(id, pack, generation, error)) {
+        LOG("Loaded lifetime stats for pack {} ({} shots).", pack_name, pack.size());
+        if (generation > 0) {
+            // Rewrite the damaged current shard from the recovered data at the next save.
+            LOG(LogLevel::Warning, "Shard for pack {} was unreadable ({}). Recovered generation {}.", pack_name, error, generation);
+            MarkPackDirty(id);
         }
     }
-    catch (const std::exception& e) {
-        cvarManager->log("Error saving persistent data to file. Error: " + std::string(e.what()));
+    else {
+        LOG(LogLevel::Error, "Error loading shard for pack {} ({}). Starting the pack fresh.", pack_name, error);
     }
+    return pack;
 }
 
-void ConsistencyTrainer::ClearLifetimeStats() {
-    if (current_pack_id_.empty()) {
-        cvarManager->log("Cannot reset lifetime stats: No active training pack loaded.");
-        return;
+void ConsistencyTrainer::RetireMonolithicFiles() {
+    // Renamed rather than deleted, so the data can still be recovered by hand, but never migrated a second time.
+    for (const std::string& path : { binaryFilePath_, dataFilePath_ }) {
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) continue;
+        std::filesystem::rename(path, path + ".migrated", ec);
+        if (ec) {
+            LOG(LogLevel::Warning, "Could not rename migrated file {} ({}). It will be migrated again if the shard index is lost.", path, ec.message());
+        }
+    }
+}
+
+void ConsistencyTrainer::LoadMonolithicStats(PersistentData& out) {
+
+    // Binary snapshot first: mapped and decoded in place, no text parsing.
+    MappedFile binary_file;
+    if (binary_file.Open(binaryFilePath_) && binary_file.Size() > 0) {
+        std::string error;
+        if (StatsBinary::Decode(binary_file.Data(), binary_file.Size(), out, error)) {
+            LOG("Loaded persistent stats for {} packs from binary file.", out.size());
+            return;
+        }
+        LOG(LogLevel::Error, "Error decoding binary persistence file ({}). Falling back to text file.", error);
     }
+    binary_file.Close();
 
-    if (global_pack_stats_.count(current_pack_id_)) {
-        global_pack_stats_.erase(current_pack_id_);
-        cvarManager->log("Lifetime stats cleared for pack: " + current_pack_id_);
+    // Legacy 6/7-segment text file.
+    std::string storage_str;
+    if (ReadWholeFile(dataFilePath_, storage_str)) {
+        LOG("Persistence file successfully opened and read.");
     }
     else {
-        cvarManager->log("No saved lifetime stats found for pack: " + current_pack_id_ + ".");
+        LOG("Persistence file does not exist or could not be opened. Starting fresh.");
     }
 
-    training_session_stats_.clear();
-
-    InitializeSessionStats();
-
-    SavePersistentStats();
+    if (!storage_str.empty()) {
+        StatsParseReport report;
+        out = DeserializeStats(storage_str, &report);
+        LogParseReport("persistence file", report);
+        LOG("Loaded persistent stats for {} packs from text file.", out.size());
+    }
 }
 
+void ConsistencyTrainer::SavePersistentStats() {
+    CT_PERF_SCOPE(perf_, PerfHook::SavePersistentStats);
+    LogWriterMessages();
 
-void ConsistencyTrainer::InitializeSessionStats()
-{
-    // Save existing pack stats before initializing the new pack
-    if (!training_session_stats_.empty() && !current_pack_id_.empty()) {
-        global_pack_stats_[current_pack_id_] = training_session_stats_;
+    if (dirty_packs_.empty()) {
+        LOG("No changed packs to save. Skipping file write.");
+        return;
     }
 
-    // CRITICAL FIX: Clear the session map before attempting to populate it.
-    training_session_stats_.clear();
+    if (!persistence_writer_) {
+        LOG(LogLevel::Error, "Error: Persistence writer is not running.");
+        return;
+    }
 
-    current_shot_index_ = 0;
-    current_attempt_boost_used_ = 0.0;
-    current_pack_id_ = GetCurrentPackID();
+    // Re-encode only the changed shots on the game thread (everything else comes from the encoding cache),
+    // then assemble and write each changed pack's shard on the writer thread.
+    // The snapshot supersedes the journal, which the writer truncates once every shard is renamed into place.
+    static const ShotPackStats empty_pack;
+    size_t encoded_bytes = 0;
+    size_t record_bytes = 0;
+    std::vector<PersistenceWriter::FileSnapshot> files;
+    for (const auto& dirty_pair : dirty_packs_) {
+        const PackId id = dirty_pair.first;
+        const PackDirtyState& dirty = dirty_pair.second;
+
+        auto it = global_pack_stats_.find(id);
+        const ShotPackStats& stats = it != global_pack_stats_.end() ? *it->second : empty_pack;
+
+        encoded_bytes += shard_store_->UpdateEncoding(id, stats, dirty.all_shots ? nullptr : &dirty.shots);
+        std::vector<StatsBinary::EncodedRecord> records = shard_store_->GetEncodedRecords(id);
+        record_bytes += records.size() * StatsBinary::RECORD_SIZE;
+
+        files.push_back({ shard_store_->GetShardPath(id), [pack_name = shard_store_->GetName(id), records = std::move(records)]() {
+            return StatsBinary::EncodePack(pack_name, records);
+        } });
+    }
 
-    if (gameWrapper->IsInCustomTraining())
-    {
-        ServerWrapper server = gameWrapper->GetCurrentGameState();
-        if (server.IsNull()) return;
+    last_save_encoded_bytes_ = encoded_bytes;
+    last_save_record_bytes_ = record_bytes;
+    total_encoded_bytes_ += encoded_bytes;
+    LOG("Saving {} pack(s): re-encoded {} of {} record bytes.", files.size(), encoded_bytes, record_bytes);
 
-        TrainingEditorWrapper training_editor(server.memory_address);
-        if (training_editor.IsNull()) return;
+    if (shard_store_->IsIndexDirty()) {
+        files.push_back({ shard_store_->GetIndexPath(), [index = shard_store_->EncodeIndex()]() { return index; } });
+        shard_store_->MarkIndexClean();
+    }
 
-        // Load persistent data for the new pack if it exists
-        PackStats pack_lifetime_stats;
-        if (global_pack_stats_.count(current_pack_id_)) {
-            pack_lifetime_stats = global_pack_stats_.at(current_pack_id_);
-        }
+    persistence_writer_->RequestSave(std::move(files));
+    dirty_packs_.clear();
+    journal_bytes_ = 0;
+}
 
-        // Only iterate up to the total number of shots in the CURRENTLY loaded pack.
-        int total_shots = training_editor.GetTotalRounds();
-        for (int i = 0; i < total_shots; ++i) {
+void ConsistencyTrainer::AppendJournalEntry(int shot_index, const ShotLifetimeStats& stats) {
+    LogWriterMessages();
 
-            // If lifetime data exists for this specific shot, load it into the session map.
-            if (pack_lifetime_stats.count(i)) {
-                training_session_stats_[i] = pack_lifetime_stats.at(i);
-            }
-            // If the shot is new, create the entry with defaults.
-            else {
-                training_session_stats_[i] = ShotStats();
-            }
+    if (current_pack_ == INVALID_PACK_ID || !persistence_writer_) return;
 
-            // Ensure session-specific and sentinel parts are correctly initialized/reset for the current session.
-            ShotStats& stats = training_session_stats_.at(i);
+    // Every journaled shot must be in the next snapshot, since that snapshot truncates the journal.
+    MarkShotDirty(current_pack_, shot_index);
 
-            // Re-initialize session-specific parts safely
-            stats.attempts = 0;
-            stats.successes = 0;
-            stats.total_boost_used = 0.0;
-            stats.total_successful_boost_used = 0.0;
-            stats.min_successful_boost_used = std::numeric_limits<double>::max();
+    std::string entry;
+    AppendStatsRecord(entry, current_pack_id_, shot_index, stats);
+    journal_bytes_ += entry.size();
+    persistence_writer_->RequestAppend(std::move(entry));
 
-            // Check loaded lifetime_min_boost for corruption.
-            if (stats.lifetime_min_boost < 1.0) {
-                stats.lifetime_min_boost = std::numeric_limits<double>::max();
-            }
-        }
-        current_shot_index_ = training_editor.GetRoundNum();
+    if (journal_bytes_ >= JOURNAL_COMPACT_BYTES) {
+        LOG("Journal passed {} bytes. Compacting.", JOURNAL_COMPACT_BYTES);
+        SavePersistentStats();
     }
-    cvarManager->log("Session stats initialized for pack: " + current_pack_id_);
 }
 
-void ConsistencyTrainer::ResetSessionStats()
-{
-    for (auto& pair : training_session_stats_) {
-        pair.second.attempts = 0;
-        pair.second.successes = 0;
-        pair.second.total_boost_used = 0.0;
-        pair.second.total_successful_boost_used = 0.0;
-        pair.second.min_successful_boost_used = std::numeric_limits<double>::max();
+void ConsistencyTrainer::RecordAttempt(const AttemptHistory::AttemptRecord& record) {
+    if (current_pack_ == INVALID_PACK_ID) return;
+
+    if (pending_history_pack_ != current_pack_) {
+        FlushAttemptHistory();
+        pending_history_pack_ = current_pack_;
     }
-    current_attempt_boost_used_ = 0.0;
-    cvarManager->log("Session stats reset by user action (values zeroed).");
-}
 
-void ConsistencyTrainer::ResetCurrentShotSessionStats(ShotStats& stats)
-{
-    stats.attempts = 0;
-    stats.successes = 0;
-    stats.total_boost_used = 0.0;
-    stats.total_successful_boost_used = 0.0;
-    stats.min_successful_boost_used = std::numeric_limits<double>::max();
-    current_attempt_boost_used_ = 0.0;
+    pending_history_.push_back(record);
+
+    if (pending_history_.size() >= HISTORY_BATCH_ATTEMPTS) {
+        FlushAttemptHistory();
+    }
 }
 
-void ConsistencyTrainer::UpdateLifetimeBest(ShotStats& stats) {
+void ConsistencyTrainer::FlushAttemptHistory() {
+    if (pending_history_.empty() || !persistence_writer_) return;
 
-    if (stats.min_successful_boost_used != std::numeric_limits<double>::max() &&
-        stats.min_successful_boost_used < stats.lifetime_min_boost)
-    {
-        stats.lifetime_min_boost = stats.min_successful_boost_used;
-        cvarManager->log("New Lifetime Best Min Boost (Individual) for Shot " + std::to_string(current_shot_index_ + 1) + ": " + std::to_string(stats.lifetime_min_boost));
+    std::string path = shard_store_->GetHistoryPath(pending_history_pack_);
+    if (shard_store_->IsIndexDirty()) {
+        // New pack: its ID must be in the saved index before anything is appended under it.
+        MarkPackDirty(pending_history_pack_);
+        EnsurePackLoaded(pending_history_pack_);
+        SavePersistentStats();
     }
 
-    if (stats.attempts > 0) {
+    persistence_writer_->RequestAppendTo(path, AttemptHistory::EncodeFrame(pending_history_));
+    pending_history_.clear();
+}
 
-        bool attempts_increased = (stats.attempts > stats.lifetime_attempts_at_best);
-        bool success_improved = (stats.successes > stats.lifetime_best_successes);
+void ConsistencyTrainer::LogAttemptHistory() {
+    if (current_pack_ == INVALID_PACK_ID) {
+        LOG("No attempt history for the current pack.");
+        return;
+    }
 
-        if (attempts_increased) {
-            stats.lifetime_attempts_at_best = stats.attempts;
-            stats.lifetime_best_successes = stats.successes;
+    FlushAttemptHistory();
+    if (persistence_writer_) persistence_writer_->Flush();
 
-            stats.lifetime_total_boost_at_best = stats.total_boost_used;
-            stats.lifetime_total_successful_boost_at_best = stats.total_successful_boost_used;
-            cvarManager->log("New Lifetime Best Run Length (Attempts/Success) for Shot " + std::to_string(current_shot_index_ + 1) + ": " + std::to_string(stats.attempts) + "/" + std::to_string(stats.successes));
-        }
+    MappedFile file;
+    if (!file.Open(shard_store_->GetHistoryPath(current_pack_))) {
+        LOG("No attempt history for the current pack.");
+        return;
+    }
 
-        if (success_improved) {
-            if (stats.successes > stats.lifetime_best_successes) {
-                stats.lifetime_best_successes = stats.successes;
-                stats.lifetime_attempts_at_best = stats.attempts;
-                stats.lifetime_total_boost_at_best = stats.total_boost_used;
-                stats.lifetime_total_successful_boost_at_best = stats.total_successful_boost_used;
-                cvarManager->log("New Absolute Best Success Count for Shot " + std::to_string(current_shot_index_ + 1) + ": " + std::to_string(stats.successes) + "/" + std::to_string(stats.attempts));
-            }
-        }
-        else if (stats.successes == stats.lifetime_best_successes)
-        {
-            if (stats.attempts >= stats.lifetime_attempts_at_best) {
+    struct ShotTotals
+    {
+        int attempts = 0;
+        int successes = 0;
+        double boost_used = 0.0;
+    };
+    std::map<int, ShotTotals> totals;
+    AttemptHistory::DecodeReport report;
+    AttemptHistory::Decode(file.Data(), file.Size(), [&](const AttemptHistory::AttemptRecord& record) {
+        ShotTotals& shot = totals[record.shot_index];
+        shot.attempts++;
+        if (record.success) shot.successes++;
+        shot.boost_used += record.boost_used;
+    }, &report);
+
+    LOG("Attempt history for {}: {} attempts in {} bytes.", current_pack_id_, report.records, file.Size());
+    if (report.skipped_bytes > 0) {
+        LOG(LogLevel::Warning, "Skipped {} unreadable history bytes (torn or corrupt frames).", report.skipped_bytes);
+    }
+    for (const auto& pair : totals) {
+        const ShotTotals& shot = pair.second;
+        LOG("Shot {}: {}/{} successful, avg boost {:.1f}", pair.first + 1, shot.successes, shot.attempts, shot.boost_used / shot.attempts);
+    }
+}
 
-                double current_total_boost = stats.total_boost_used;
-                double best_total_boost = stats.lifetime_total_boost_at_best;
+#if CT_PERF_STATS
+void ConsistencyTrainer::LogPerfCounters() {
+    // Times are inclusive: RenderWindow contains the event handlers it applies, SavePersistentStats its callers' share.
+    // Sampled hooks report every call, the number timed, and a total extrapolated from the timed ones.
+    for (size_t i = 0; i < static_cast<size_t>(PerfHook::Count); ++i) {
+        const PerfHook hook = static_cast<PerfHook>(i);
+        const LatencyHistogram& histogram = perf_[hook];
+        const uint64_t timed = histogram.Count();
+        const uint64_t calls = perf_.SampledCalls(hook) > 0 ? perf_.SampledCalls(hook) : timed;
+        const double total_ns = timed > 0 ? static_cast<double>(histogram.TotalNs()) * calls / timed : 0.0;
+        LOG("{}: calls={} timed={} p50={:.1f} us p99={:.1f} us max={:.1f} us total={:.2f} ms", PerfHookName(hook), calls, timed,
+            histogram.PercentileNs(0.50) / 1000.0, histogram.PercentileNs(0.99) / 1000.0, histogram.MaxNs() / 1000.0,
+            total_ns / 1000000.0);
+    }
+}
+#endif
 
-                if (current_total_boost < best_total_boost) {
-                    stats.lifetime_attempts_at_best = stats.attempts;
-                    stats.lifetime_total_boost_at_best = current_total_boost;
-                    stats.lifetime_total_successful_boost_at_best = stats.total_successful_boost_used;
-                    cvarManager->log("Boost Tie-breaker Update for Shot " + std::to_string(current_shot_index_ + 1) + ". Same success count, but less total boost used.");
-                }
-            }
-        }
+void ConsistencyTrainer::LogWriterMessages() {
+    if (!persistence_writer_) return;
+
+    // Writer messages are classified by their prefix so ct_log_level can filter them.
+    for (const std::string& message : persistence_writer_->TakeMessages()) {
+        const LogLevel level = message.rfind("Error", 0) == 0 ? LogLevel::Error
+            : message.rfind("Warning", 0) == 0 ? LogLevel::Warning : LogLevel::Info;
+        LOG(level, "{}", message);
     }
 }
 
+void ConsistencyTrainer::ClearLifetimeStats() {
+    if (current_pack_ == INVALID_PACK_ID) {
+        LOG("Cannot reset lifetime stats: No active training pack loaded.");
+        return;
+    }
 
-bool ConsistencyTrainer::IsShotFrozen()
-{
-    if (training_session_stats_.find(current_shot_index_) == training_session_stats_.end()) return true;
+    ShotPackStats& pack = EnsurePackLoaded(current_pack_);
+    if (!pack.empty()) {
+        // Keep an empty (loaded) entry so the stale shard is not read back before the save replaces it.
+        pack.clear();
+        MarkPackDirty(current_pack_);
+        LOG("Lifetime stats cleared for pack: {}", current_pack_id_);
+    }
+    else {
+        LOG("No saved lifetime stats found for pack: {}.", current_pack_id_);
+    }
+
+    core_.ClearSession();
+
+    InitializeSessionStats();
 
-    ShotStats& stats = training_session_stats_.at(current_shot_index_);
-    return stats.attempts >= max_attempts_per_shot_;
+    SavePersistentStats();
 }
 
-void ConsistencyTrainer::OnSetVehicleInput(std::string eventName)
+
+void ConsistencyTrainer::InitializeSessionStats()
 {
-    if (!is_plugin_enabled_ || !gameWrapper->IsInCustomTraining() || IsShotFrozen()) return;
+    // Save existing pack stats before initializing the new pack
+    if (!core_.Stats().empty() && current_pack_ != INVALID_PACK_ID) {
+        CommitShot(core_.CurrentShot());
+    }
 
-    if (training_session_stats_.empty()) return;
+    // CRITICAL FIX: Clear the session map before attempting to populate it.
+    core_.ClearSession();
 
-    CarWrapper car = gameWrapper->GetLocalCar();
-    if (car.IsNull()) return;
+    current_pack_id_ = GetCurrentPackID();
+    // The only string lookup per pack: everything per attempt uses the interned ID.
+    current_pack_ = current_pack_id_.empty() ? INVALID_PACK_ID : shard_store_->Intern(current_pack_id_);
 
-    ControllerInput input = car.GetInput();
+    if (gameWrapper->IsInCustomTraining())
+    {
+        ServerWrapper server = gameWrapper->GetCurrentGameState();
+        if (server.IsNull()) return;
 
-    const double BOOST_PER_TICK = (33.333333 / 120.0);
+        TrainingEditorWrapper training_editor(server.memory_address);
+        if (training_editor.IsNull()) return;
 
-    if (input.HoldingBoost) {
-        current_attempt_boost_used_ += BOOST_PER_TICK;
+        // View the pack's lifetime stats in place (read from its shard on first access).
+        // Only iterate up to the total number of shots in the CURRENTLY loaded pack; session counters start zeroed.
+        core_.BindPack(current_pack_ == INVALID_PACK_ID ? nullptr : &EnsurePackLoaded(current_pack_),
+            training_editor.GetTotalRounds(), training_editor.GetRoundNum());
     }
+    UpdateVehicleInputHook(IsInValidTraining());
+    LOG("Session stats initialized for pack: {}", current_pack_id_);
 }
 
+void ConsistencyTrainer::ResetSessionStats()
+{
+    core_.ResetSession();
+    LOG("Session stats reset by user action (values zeroed).");
+}
 
-void ConsistencyTrainer::OnShotAttempt(void* params)
+void ConsistencyTrainer::OnSetVehicleInput(const std::string& eventName)
 {
-    if (!is_plugin_enabled_ || !IsInValidTraining()) return;
+    CT_PERF_SCOPE_SAMPLED(perf_, PerfHook::SetVehicleInput);
+    vehicle_input_calls_++;
+    if (!attempt_armed_) {
+        // Only reachable outside training if it ended without GameEvent_Soccar_TA.Destroyed; drop the hook outside the callback.
+        // One queued unhook is enough; the ticks until it runs are still counted.
+        if (vehicle_input_unhook_pending_) {
+            vehicle_input_calls_outside_training_++;
+        }
+        else if (!gameWrapper->IsInCustomTraining()) {
+            vehicle_input_calls_outside_training_++;
+            vehicle_input_unhook_pending_ = true;
+            gameWrapper->Execute([this](GameWrapper*) { UpdateVehicleInputHook(false); });
+        }
+        return;
+    }
 
-    if (training_session_stats_.find(current_shot_index_) == training_session_stats_.end()) {
-        training_session_stats_[current_shot_index_] = ShotStats();
+    if (armed_car_.GetInput().HoldingBoost) {
+        boost_total_++;
     }
-    ShotStats& stats = training_session_stats_.at(current_shot_index_);
+}
 
-    if (stats.attempts < max_attempts_per_shot_) {
 
-        if (stats.attempts + 1 > stats.lifetime_attempts_at_best) {
-            stats.lifetime_attempts_at_best = stats.attempts + 1;
+void ConsistencyTrainer::PushGameEvent(GameEvent::Type type, int32_t value) {
+    GameEvent event;
+    event.type = type;
+    event.value = value;
+    event.time = std::chrono::steady_clock::now();
+    event.boost_total = boost_total_;
+    game_events_.TryPush(event);
+}
 
-            cvarManager->log("New Lifetime Best Run Length (Attempts) set to: " + std::to_string(stats.lifetime_attempts_at_best) + " upon shot start.");
+void ConsistencyTrainer::ProcessGameEvents() {
+    game_events_processed_ += game_events_.Drain([this](const GameEvent& event) {
+        switch (event.type) {
+        case GameEvent::Type::SessionStarted: InitializeSessionStats(); break;
+        case GameEvent::Type::ShotAttempt: OnShotAttempt(event); break;
+        case GameEvent::Type::GoalScored: OnGoalScored(event); break;
+        case GameEvent::Type::ShotReset: OnShotReset(event); break;
+        case GameEvent::Type::BallExploded: OnBallExploded(event); break;
+        case GameEvent::Type::PlaylistIndexChanged: OnPlaylistIndexChanged(event); break;
         }
-
-        stats.attempts++;
-        cvarManager->log("Shot attempt " + std::to_string(stats.attempts) + " started (Immediate Increment). Boost counter reset to 0.0.");
-    }
-    else if (stats.attempts >= max_attempts_per_shot_) {
-        ResetCurrentShotSessionStats(stats);
-        stats.attempts = 1;
-        cvarManager->log("Max attempts exceeded/Stuck counter. Forced Reset. Starting Attempt 1 of new run.");
-    }
-
-    current_attempt_boost_used_ = 0.0;
+    });
 }
 
-void ConsistencyTrainer::OnGoalScored(void* params)
+void ConsistencyTrainer::OnShotAttempt(const GameEvent& event)
 {
+    CT_PERF_SCOPE(perf_, PerfHook::ShotAttempt);
     if (!is_plugin_enabled_ || !IsInValidTraining()) return;
 
-    gameWrapper->SetTimeout([this](...) {
-        HandleAttempt(true);
-    }, 0.05f);
+    core_.OnShotAttempt(event.time, event.boost_total);
 }
 
-void ConsistencyTrainer::OnShotReset(ActorWrapper caller, void* params, std::string eventName)
+void ConsistencyTrainer::OnGoalScored(const GameEvent& event)
 {
+    CT_PERF_SCOPE(perf_, PerfHook::GoalScored);
     if (!is_plugin_enabled_ || !IsInValidTraining()) return;
 
-    if (plugin_initiated_reset_) {
-        plugin_initiated_reset_ = false;
-        return;
-    }
-
-    gameWrapper->SetTimeout([this](...) {
-        HandleAttempt(false);
-    }, 0.05f);
+    core_.OnOutcome(true, event.time, event.boost_total);
 }
 
-void ConsistencyTrainer::OnBallExploded(void* params)
+void ConsistencyTrainer::OnShotReset(const GameEvent& event)
 {
+    CT_PERF_SCOPE(perf_, PerfHook::ShotReset);
     if (!is_plugin_enabled_ || !IsInValidTraining()) return;
 
-    gameWrapper->SetTimeout([this](...) {
-        HandleAttempt(false);
-    }, 0.05f);
+    core_.OnShotReset(event.time, event.boost_total);
 }
 
-void ConsistencyTrainer::OnPlaylistIndexChanged(ActorWrapper caller, void* params, std::string eventName)
+void ConsistencyTrainer::OnBallExploded(const GameEvent& event)
 {
-    if (!is_plugin_enabled_ || params == nullptr) return;
-
-    PlaylistIndexParams* p = static_cast<PlaylistIndexParams*>(params);
-    int new_index = p->Index;
-
-    int total_shots = GetTotalRounds();
-
-    if (total_shots > 0 && new_index >= total_shots) {
-        new_index = 0;
-        cvarManager->log("Playlist index looped FORWARD. Corrected index from " + std::to_string(p->Index) + " to " + std::to_string(new_index));
-    }
-    else if (total_shots > 0 && new_index < 0) {
-        new_index = total_shots - 1;
-        cvarManager->log("Playlist index looped BACKWARD. Corrected index from " + std::to_string(p->Index) + " to " + std::to_string(new_index));
-    }
-
-
-    if (current_shot_index_ != new_index && !training_session_stats_.empty()) {
-        UpdateLifetimeBest(training_session_stats_[current_shot_index_]);
+    CT_PERF_SCOPE(perf_, PerfHook::BallExploded);
+    if (!is_plugin_enabled_ || !IsInValidTraining()) return;
 
-        if (!current_pack_id_.empty()) {
-            global_pack_stats_[current_pack_id_] = training_session_stats_;
-        }
+    core_.OnOutcome(false, event.time, event.boost_total);
+}
 
-        SavePersistentStats();
-    }
+void ConsistencyTrainer::OnPlaylistIndexChanged(const GameEvent& event)
+{
+    CT_PERF_SCOPE(perf_, PerfHook::PlaylistIndexChanged);
+    if (!is_plugin_enabled_) return;
 
-    if (current_shot_index_ != new_index) {
-        current_shot_index_ = new_index;
-        cvarManager->log("Playlist index changed to: " + std::to_string(current_shot_index_));
-    }
-    current_attempt_boost_used_ = 0.0;
+    core_.OnShotChanged(event.value, GetTotalRounds());
 }
 
 
 bool ConsistencyTrainer::IsInValidTraining() { return gameWrapper->IsInCustomTraining(); }
 
-void ConsistencyTrainer::HandleAttempt(bool isSuccess)
+void ConsistencyTrainer::OnAttemptStateChanged()
 {
-    if (training_session_stats_.find(current_shot_index_) == training_session_stats_.end()) {
-        return;
-    }
-
-    ShotStats& stats = training_session_stats_.at(current_shot_index_);
-
-    if (stats.attempts == 0) {
-        cvarManager->log("Skipping HandleAttempt: Attempt count is 0 (Race condition/Reset overlap).");
-        return;
-    }
-
-    bool is_final_attempt = stats.attempts == max_attempts_per_shot_;
-
-    stats.total_boost_used += current_attempt_boost_used_;
-
-    if (isSuccess) {
-        stats.successes++;
-        stats.total_successful_boost_used += current_attempt_boost_used_;
-        if (current_attempt_boost_used_ < stats.min_successful_boost_used) {
-            stats.min_successful_boost_used = current_attempt_boost_used_;
-        }
-        cvarManager->log("SUCCESS recorded. Attempt " + std::to_string(stats.attempts) + ". Boost Used: " + std::to_string(current_attempt_boost_used_));
-    }
-    else {
-        cvarManager->log("FAILURE recorded. Attempt " + std::to_string(stats.attempts) + ". Boost Used: " + std::to_string(current_attempt_boost_used_));
-    }
-
-    current_attempt_boost_used_ = 0.0;
-
-    UpdateLifetimeBest(stats);
-
-    if (!current_pack_id_.empty()) {
-        global_pack_stats_[current_pack_id_] = training_session_stats_;
-    }
-
-    SavePersistentStats();
-
-    if (!is_final_attempt) {
-        gameWrapper->SetTimeout([this](...) {
-            this->RepeatCurrentShot();
-        }, 0.10f);
-    }
-    else {
-        ResetCurrentShotSessionStats(stats);
+    // Within a session the hook stays as it is and only the armed state is refreshed.
+    UpdateVehicleInputHook(IsInValidTraining());
+}
 
-        cvarManager->log("Shot " + std::to_string(current_shot_index_ + 1) + " completed max attempts. Session stats reset and shot repeated (new run started).");
-        gameWrapper->SetTimeout([this](...) { RepeatCurrentShot(); }, 0.10f);
+void ConsistencyTrainer::CommitLifetime(int shot_index, const ShotLifetimeStats& lifetime)
+{
+    if (CommitShot(shot_index)) {
+        AppendJournalEntry(shot_index, lifetime);
     }
 }
 
 void ConsistencyTrainer::RepeatCurrentShot()
 {
-    plugin_initiated_reset_ = true;
     cvarManager->executeCommand("shot_reset");
 }
 
@@ -595,9 +832,18 @@ std::string ConsistencyTrainer::GetPluginName() { return "ConsistencyTrainer"; }
 
 void ConsistencyTrainer::RenderSettings()
 {
-    if (ImGui::Checkbox("Enable Plugin", &is_plugin_enabled_)) { cvarManager->getCvar("ct_plugin_enabled").setValue(is_plugin_enabled_); }
+    CT_PERF_SCOPE(perf_, PerfHook::RenderSettings);
+    // This runs on the render thread. Anything that touches game or stats state (including cvars whose change
+    // handlers do) is handed to the game thread with Execute, where ProcessGameEvents runs.
+    bool enabled = is_plugin_enabled_;
+    if (ImGui::Checkbox("Enable Plugin", &enabled)) {
+        gameWrapper->Execute([this, enabled](GameWrapper*) { cvarManager->getCvar("ct_plugin_enabled").setValue(enabled); });
+    }
     ImGui::Spacing();
-    if (ImGui::SliderInt("Max Attempts Per Shot", &max_attempts_per_shot_, 1, 50)) { cvarManager->getCvar("ct_max_attempts").setValue(max_attempts_per_shot_); }
+    int max_attempts = core_.MaxAttemptsPerShot();
+    if (ImGui::SliderInt("Max Attempts Per Shot", &max_attempts, 1, 50)) {
+        gameWrapper->Execute([this, max_attempts](GameWrapper*) { cvarManager->getCvar("ct_max_attempts").setValue(max_attempts); });
+    }
     ImGui::Spacing();
     ImGui::Text("Display Settings:");
     if (ImGui::SliderInt("Text X Position", &text_pos_x_, 0, 1920)) { cvarManager->getCvar("ct_text_x").setValue(text_pos_x_); }
@@ -611,19 +857,20 @@ void ConsistencyTrainer::RenderSettings()
     if (ImGui::Checkbox("Show Boost Stats", &show_boost_stats_)) { cvarManager->getCvar("ct_show_boost").setValue(show_boost_stats_); }
 
     ImGui::SameLine();
-    if (ImGui::Button("Reset Current Session Stats")) { ResetSessionStats(); }
+    if (ImGui::Button("Reset Current Session Stats")) { gameWrapper->Execute([this](GameWrapper*) { ResetSessionStats(); }); }
 
     ImGui::SameLine();
-    if (ImGui::Button("Reset Lifetime Stats")) { ClearLifetimeStats(); }
+    if (ImGui::Button("Reset Lifetime Stats")) { gameWrapper->Execute([this](GameWrapper*) { ClearLifetimeStats(); }); }
 
     ImGui::Spacing();
-    if (ImGui::Button("Manually Save Lifetime Stats")) { SavePersistentStats(); }
+    if (ImGui::Button("Manually Save Lifetime Stats")) { gameWrapper->Execute([this](GameWrapper*) { SavePersistentStats(); }); }
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Spacing();
     ImGui::Text("Overall Session Stats:");
     ImGui::Text("Active Pack: %s", current_pack_id_.empty() ? "None" : current_pack_id_.c_str());
-    if (training_session_stats_.empty()) { ImGui::Text("Load a training pack to see shot list."); }
+    const SessionShotStats& session_stats = core_.Stats();
+    if (session_stats.empty()) { ImGui::Text("Load a training pack to see shot list."); }
     else
     {
         ImGui::Columns(7, "session_stats_table", true);
@@ -637,32 +884,33 @@ void ConsistencyTrainer::RenderSettings()
         ImGui::Text("Avg Boost (Success/Best)"); ImGui::NextColumn();
         ImGui::Text("Min Boost (Curr/Best)"); ImGui::NextColumn();
         ImGui::Separator();
-        for (const auto& pair : training_session_stats_)
+        for (int shot = 0; shot < static_cast<int>(session_stats.size()); ++shot)
         {
-            double current_successes_d = static_cast<double>(pair.second.successes);
-            double current_attempts_d = static_cast<double>(pair.second.attempts);
-            double best_successes_d = static_cast<double>(pair.second.lifetime_best_successes);
-            double best_attempts_d = static_cast<double>(pair.second.lifetime_attempts_at_best);
+            const ShotSessionStats& session = session_stats.Session(shot);
+            const ShotLifetimeStats& lifetime = session_stats.Lifetime(shot);
+
+            double current_successes_d = static_cast<double>(session.successes);
+            double current_attempts_d = static_cast<double>(session.attempts);
+            double best_successes_d = static_cast<double>(lifetime.lifetime_best_successes);
+            double best_attempts_d = static_cast<double>(lifetime.lifetime_attempts_at_best);
 
-            double consistency = (pair.second.attempts > 0) ? (current_successes_d / current_attempts_d * 100.0) : 0.0;
-            double best_consistency = (pair.second.lifetime_attempts_at_best > 0) ? (best_successes_d / best_attempts_d * 100.0) : 0.0;
+            double consistency = (session.attempts > 0) ? (current_successes_d / current_attempts_d * 100.0) : 0.0;
+            double best_consistency = (lifetime.lifetime_attempts_at_best > 0) ? (best_successes_d / best_attempts_d * 100.0) : 0.0;
 
-            double avg_boost = (pair.second.attempts > 0) ? (pair.second.total_boost_used / current_attempts_d) : 0.0;
-            double avg_success_boost = (pair.second.successes > 0) ? (pair.second.total_successful_boost_used / current_successes_d) : 0.0;
-            double avg_success_boost_best_consist = (pair.second.lifetime_attempts_at_best > 0 && pair.second.lifetime_best_successes > 0) ? (pair.second.lifetime_total_successful_boost_at_best / best_successes_d) : 0.0;
+            double avg_boost = (session.attempts > 0) ? (BoostTicksToAmount(session.total_boost_ticks) / current_attempts_d) : 0.0;
+            double avg_success_boost = (session.successes > 0) ? (BoostTicksToAmount(session.total_successful_boost_ticks) / current_successes_d) : 0.0;
+            double avg_success_boost_best_consist = (lifetime.lifetime_attempts_at_best > 0 && lifetime.lifetime_best_successes > 0) ? (BoostTicksToAmount(lifetime.lifetime_total_successful_boost_ticks_at_best) / best_successes_d) : 0.0;
 
-            double sentinel = std::numeric_limits<double>::max();
-            double min_success_boost_curr = (pair.second.min_successful_boost_used != sentinel) ? pair.second.min_successful_boost_used : 0.0;
+            double min_success_boost_curr = (session.min_successful_boost_ticks != NO_BOOST_TICKS) ? BoostTicksToAmount(session.min_successful_boost_ticks) : 0.0;
 
-            // Re-implementing the display logic check for lifetime_min_boost
             // The condition is: display the actual boost ONLY if it is NOT the sentinel value.
-            bool is_lifetime_boost_set = pair.second.lifetime_min_boost < 100000000.0; // Check if it's less than a huge number (safely avoiding sentinel corruption)
+            bool is_lifetime_boost_set = lifetime.lifetime_min_boost_ticks != NO_BOOST_TICKS;
 
-            double display_life_min_boost = pair.second.lifetime_min_boost;
+            double display_life_min_boost = BoostTicksToAmount(lifetime.lifetime_min_boost_ticks);
 
-            ImGui::Text("%d", pair.first + 1); ImGui::NextColumn();
-            ImGui::Text("%d/%d", pair.second.successes, pair.second.lifetime_best_successes); ImGui::NextColumn();
-            ImGui::Text("%d/%d", pair.second.attempts, pair.second.lifetime_attempts_at_best); ImGui::NextColumn();
+            ImGui::Text("%d", shot + 1); ImGui::NextColumn();
+            ImGui::Text("%d/%d", session.successes, lifetime.lifetime_best_successes); ImGui::NextColumn();
+            ImGui::Text("%d/%d", session.attempts, lifetime.lifetime_attempts_at_best); ImGui::NextColumn();
             ImGui::Text("%.1f%%/%.1f%%", (float)consistency, (float)best_consistency); ImGui::NextColumn();
             ImGui::Text("%.1f", (float)avg_boost); ImGui::NextColumn();
             ImGui::Text("%.1f/%.1f", (float)avg_success_boost, (float)avg_success_boost_best_consist); ImGui::NextColumn();
@@ -679,15 +927,102 @@ void ConsistencyTrainer::RenderSettings()
         }
         ImGui::Columns(1);
     }
+#if CT_PERF_STATS
+    RenderDiagnostics();
+#endif
 }
 
+#if CT_PERF_STATS
+void ConsistencyTrainer::SampleDiagnostics(size_t queued_game_events, size_t drained_log_lines) {
+    Diagnostics& d = diagnostics_;
+
+    // RenderWindow runs once per frame, so the growth of its total is what the previous frame cost.
+    const uint64_t render_window_ns = perf_[PerfHook::RenderWindow].TotalNs();
+    d.render_window_us.Push(static_cast<float>(render_window_ns - d.last_render_window_ns) / 1000.0f);
+    d.last_render_window_ns = render_window_ns;
+    d.queued_game_events.Push(static_cast<float>(queued_game_events));
+    d.queued_log_lines.Push(static_cast<float>(drained_log_lines));
+    d.log_lines += drained_log_lines;
+
+    if (persistence_writer_) {
+        const PersistenceWriter::SaveStats save = persistence_writer_->GetSaveStats();
+        if (save.saves != d.last_save_count) {
+            d.save_ms.Push(static_cast<float>(save.last_save_ms));
+            d.save_kb.Push(static_cast<float>(save.last_save_bytes) / 1024.0f);
+            d.last_save_count = save.saves;
+        }
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (d.rate_window_start == std::chrono::steady_clock::time_point{}) d.rate_window_start = now;
+    const double seconds = std::chrono::duration<double>(now - d.rate_window_start).count();
+    if (seconds >= 1.0) {
+        d.vehicle_input_per_second.Push(static_cast<float>((vehicle_input_calls_ - d.rate_vehicle_input_calls) / seconds));
+        d.game_events_per_second.Push(static_cast<float>((game_events_processed_ - d.rate_game_events) / seconds));
+        d.log_lines_per_second.Push(static_cast<float>((d.log_lines - d.rate_log_lines) / seconds));
+        d.rate_vehicle_input_calls = vehicle_input_calls_;
+        d.rate_game_events = game_events_processed_;
+        d.rate_log_lines = d.log_lines;
+        d.rate_window_start = now;
+    }
+}
+
+void ConsistencyTrainer::RenderDiagnostics() {
+    if (!ImGui::CollapsingHeader("Diagnostics")) return;
+
+    const Diagnostics& d = diagnostics_;
+    const ImVec2 plot_size(0.0f, 60.0f);
+    char overlay[96];
+
+    snprintf(overlay, sizeof(overlay), "last %.1f us, max %.1f us", d.render_window_us.Latest(), d.render_window_us.Max());
+    ImGui::PlotHistogram("RenderWindow per frame (us)", &PlotRing<256>::HistogramGetter, const_cast<PlotRing<256>*>(&d.render_window_us), 1,
+        PlotRing<256>::Size(), 0, overlay, 0.0f, d.render_window_us.Max(), plot_size);
+
+    static const char* const backlog_names[] = { "Game events", "Log lines" };
+    static const ImColor backlog_colors[] = { ImColor(100, 180, 255), ImColor(255, 180, 100) };
+    const void* const backlog_data[] = { &d.queued_game_events, &d.queued_log_lines };
+    ImGui::PlotMultiLines("Queued per frame", 2, const_cast<const char**>(backlog_names), backlog_colors, &PlotRing<256>::LineGetter, backlog_data,
+        PlotRing<256>::Size(), 0.0f, std::max(1.0f, std::max(d.queued_game_events.Max(), d.queued_log_lines.Max())), plot_size);
+
+    snprintf(overlay, sizeof(overlay), "last %.2f ms, max %.2f ms", d.save_ms.Latest(), d.save_ms.Max());
+    ImGui::PlotHistogram("Save time (ms)", &PlotRing<64>::HistogramGetter, const_cast<PlotRing<64>*>(&d.save_ms), 1,
+        PlotRing<64>::Size(), 0, overlay, 0.0f, d.save_ms.Max(), plot_size);
+
+    snprintf(overlay, sizeof(overlay), "last %.1f KB, max %.1f KB", d.save_kb.Latest(), d.save_kb.Max());
+    ImGui::PlotHistogram("Written per save (KB)", &PlotRing<64>::HistogramGetter, const_cast<PlotRing<64>*>(&d.save_kb), 1,
+        PlotRing<64>::Size(), 0, overlay, 0.0f, d.save_kb.Max(), plot_size);
+
+    static const char* const rate_names[] = { "SetVehicleInput", "Game events", "Log lines" };
+    static const ImColor rate_colors[] = { ImColor(100, 225, 100), ImColor(100, 180, 255), ImColor(255, 180, 100) };
+    const void* const rate_data[] = { &d.vehicle_input_per_second, &d.game_events_per_second, &d.log_lines_per_second };
+    const float rate_max = std::max({ 1.0f, d.vehicle_input_per_second.Max(), d.game_events_per_second.Max(), d.log_lines_per_second.Max() });
+    ImGui::PlotMultiLines("Hook calls per second", 3, const_cast<const char**>(rate_names), rate_colors, &PlotRing<60>::LineGetter, rate_data,
+        PlotRing<60>::Size(), 0.0f, rate_max, plot_size);
+}
+#endif
+
 void ConsistencyTrainer::SetImGuiContext(uintptr_t ctx) { ImGui::SetCurrentContext(reinterpret_cast<ImGuiContext*>(ctx)); }
 
 void ConsistencyTrainer::RenderWindow(CanvasWrapper canvas)
 {
+    CT_PERF_SCOPE(perf_, PerfHook::RenderWindow);
+    // Drawables run once per frame whether or not the window is shown, so this is where queued game events are applied.
+#if CT_PERF_STATS
+    const size_t queued_game_events = game_events_.size();
+#endif
+    ProcessGameEvents();
+    const size_t drained_log_lines = DrainLog();
+#if CT_PERF_STATS
+    SampleDiagnostics(queued_game_events, drained_log_lines);
+#else
+    (void)drained_log_lines;
+#endif
+
     if (!is_plugin_enabled_ || !is_window_open_ || !IsInValidTraining()) { return; }
 
-    if (training_session_stats_.find(current_shot_index_) == training_session_stats_.end())
+    const SessionShotStats& session_stats = core_.Stats();
+    const int current_shot = core_.CurrentShot();
+    if (!session_stats.Contains(current_shot))
     {
         canvas.SetColor(255, 255, 255, 255);
         canvas.SetPosition(Vector2{ text_pos_x_, text_pos_y_ });
@@ -695,27 +1030,27 @@ void ConsistencyTrainer::RenderWindow(CanvasWrapper canvas)
         return;
     }
 
-    ShotStats& current_stats = training_session_stats_.at(current_shot_index_);
+    const ShotSessionStats& current_stats = session_stats.Session(current_shot);
+    const ShotLifetimeStats& lifetime = session_stats.Lifetime(current_shot);
 
     double current_successes_d = static_cast<double>(current_stats.successes);
     double current_attempts_d = static_cast<double>(current_stats.attempts);
-    double best_successes_d = static_cast<double>(current_stats.lifetime_best_successes);
-    double best_attempts_d = static_cast<double>(current_stats.lifetime_attempts_at_best);
+    double best_successes_d = static_cast<double>(lifetime.lifetime_best_successes);
+    double best_attempts_d = static_cast<double>(lifetime.lifetime_attempts_at_best);
 
     double consistency = (current_stats.attempts > 0) ? (current_successes_d / current_attempts_d * 100.0) : 0.0;
-    double best_consistency = (current_stats.lifetime_attempts_at_best > 0) ? (best_successes_d / best_attempts_d * 100.0) : 0.0;
+    double best_consistency = (lifetime.lifetime_attempts_at_best > 0) ? (best_successes_d / best_attempts_d * 100.0) : 0.0;
 
-    double avg_boost = (current_stats.attempts > 0) ? (current_stats.total_boost_used / current_attempts_d) : 0.0;
-    double avg_success_boost = (current_stats.successes > 0) ? (current_stats.total_successful_boost_used / current_successes_d) : 0.0;
-    double avg_success_boost_best_consist = (current_stats.lifetime_attempts_at_best > 0 && current_stats.lifetime_best_successes > 0) ? (current_stats.lifetime_total_successful_boost_at_best / best_successes_d) : 0.0;
+    double avg_boost = (current_stats.attempts > 0) ? (BoostTicksToAmount(current_stats.total_boost_ticks) / current_attempts_d) : 0.0;
+    double avg_success_boost = (current_stats.successes > 0) ? (BoostTicksToAmount(current_stats.total_successful_boost_ticks) / current_successes_d) : 0.0;
+    double avg_success_boost_best_consist = (lifetime.lifetime_attempts_at_best > 0 && lifetime.lifetime_best_successes > 0) ? (BoostTicksToAmount(lifetime.lifetime_total_successful_boost_ticks_at_best) / best_successes_d) : 0.0;
 
-    double sentinel = std::numeric_limits<double>::max();
-    double min_success_boost_curr = (current_stats.min_successful_boost_used != sentinel) ? current_stats.min_successful_boost_used : 0.0;
+    double min_success_boost_curr = (current_stats.min_successful_boost_ticks != NO_BOOST_TICKS) ? BoostTicksToAmount(current_stats.min_successful_boost_ticks) : 0.0;
 
-    // Re-implementing the display logic check for lifetime_min_boost
-    bool is_lifetime_boost_set = current_stats.lifetime_min_boost < 100000000.0; // Check if it's less than a huge number
+    // Only shown once a successful attempt has set it.
+    bool is_lifetime_boost_set = lifetime.lifetime_min_boost_ticks != NO_BOOST_TICKS;
 
-    double display_life_min_boost = current_stats.lifetime_min_boost;
+    double display_life_min_boost = BoostTicksToAmount(lifetime.lifetime_min_boost_ticks);
 
     float line_height = 20.0f * text_scale_;
     int current_y = text_pos_y_;
@@ -724,17 +1059,17 @@ void ConsistencyTrainer::RenderWindow(CanvasWrapper canvas)
     canvas.SetColor(255, 255, 255, 255);
 
     if (show_consistency_stats_) {
-        snprintf(buffer, sizeof(buffer), "Current Shot: %d", current_shot_index_ + 1);
+        snprintf(buffer, sizeof(buffer), "Current Shot: %d", current_shot + 1);
         canvas.SetPosition(Vector2{ text_pos_x_, current_y });
         canvas.DrawString(buffer, text_scale_, text_scale_);
         current_y += line_height;
 
-        snprintf(buffer, sizeof(buffer), "Attempts: %d/%d (Best: %d)", current_stats.attempts, max_attempts_per_shot_, current_stats.lifetime_attempts_at_best);
+        snprintf(buffer, sizeof(buffer), "Attempts: %d/%d (Best: %d)", current_stats.attempts, core_.MaxAttemptsPerShot(), lifetime.lifetime_attempts_at_best);
         canvas.SetPosition(Vector2{ text_pos_x_, current_y });
         canvas.DrawString(buffer, text_scale_, text_scale_);
         current_y += line_height;
 
-        snprintf(buffer, sizeof(buffer), "Successes: %d / Best: %d", current_stats.successes, current_stats.lifetime_best_successes);
+        snprintf(buffer, sizeof(buffer), "Successes: %d / Best: %d", current_stats.successes, lifetime.lifetime_best_successes);
         canvas.SetPosition(Vector2{ text_pos_x_, current_y });
         canvas.DrawString(buffer, text_scale_, text_scale_);
         current_y += line_height;
@@ -777,7 +1112,7 @@ void ConsistencyTrainer::RenderWindow(CanvasWrapper canvas)
         canvas.DrawString(buffer, text_scale_, text_scale_);
         current_y += line_height;
 
-        snprintf(buffer, sizeof(buffer), "Boost Current: %.1f", (float)current_attempt_boost_used_);
+        snprintf(buffer, sizeof(buffer), "Boost Current: %.1f", (float)BoostTicksToAmount(core_.AttemptBoostTicks(boost_total_)));
         canvas.SetPosition(Vector2{ text_pos_x_, current_y });
         canvas.DrawString(buffer, text_scale_, text_scale_);
     }
@@ -10,39 +10,32 @@
 #include "bakkesmod/wrappers/GameObject/CarWrapper.h"
 #include "bakkesmod/wrappers/PlayerControllerWrapper.h"
 
+#include "ShotStats.h"
+#include "StatsTextFormat.h"
+#include "PersistenceWriter.h"
+#include "PackShardStore.h"
+#include "AttemptHistory.h"
+#include "BoostDeltaMeter.h"
+#include "SpscRing.h"
+#include "PerfCounters.h"
+#include "PlotRing.h"
+#include "TrainerCore.h"
+
 #include <string>
 #include <map>
 #include <limits>
 #include <sstream>
-
-// Struct to hold statistics for a single shot
-struct ShotStats
-{
-    int attempts = 0;
-    int successes = 0;
-    // Boost tracking variables (Current Session)
-    float total_boost_used = 0.0f;
-    float total_successful_boost_used = 0.0f;
-    float min_successful_boost_used = std::numeric_limits<float>::max();
-
-    // Persistent Lifetime Bests (Metrics tracked from the best consistency run)
-    int lifetime_best_successes = 0;
-    int lifetime_attempts_at_best = 0;
-    float lifetime_total_boost_at_best = 0.0f;
-    float lifetime_total_successful_boost_at_best = 0.0f;
-    float lifetime_min_boost = std::numeric_limits<float>::max(); // Absolute lowest boost used on any successful shot
-};
-
-// This map holds all lifetime ShotStats, keyed by Shot Index (int).
-using ShotPackStats = std::map<int, ShotStats>;
-// This map holds all ShotPacks, keyed by the Training Pack Code (string).
-using PersistentData = std::map<std::string, ShotPackStats>;
+#include <memory>
+#include <set>
+#include <chrono>
+#include <vector>
 
 // Forward declaration of CVarManagerWrapper and GameWrapper to resolve linker errors
 class CVarManagerWrapper;
 class GameWrapper;
 
-class ConsistencyTrainer : public BakkesMod::Plugin::BakkesModPlugin, public BakkesMod::Plugin::PluginSettingsWindow
+// The SDK side of the trainer: hooks, cvars, persistence and UI around a TrainerCore, for which it is the TrainerHost.
+class ConsistencyTrainer : public BakkesMod::Plugin::BakkesModPlugin, public BakkesMod::Plugin::PluginSettingsWindow, private TrainerHost
 {
 public:
     // Overrides from BakkesModPlugin
@@ -60,11 +53,57 @@ public:
 private:
     // Persistence file path storage
     std::string dataFilePath_; // ?? ADDED: Member to store the absolute file path
+    // Single-file formats from before sharding, only read to migrate them.
+    std::string binaryFilePath_;
+    // One shard file per pack plus index.txt (PackShardStore.h).
+    std::string shardDirectory_;
+    std::unique_ptr<PackShardStore> shard_store_;
+    // Shots changed since the last snapshot; only these are re-encoded by SavePersistentStats.
+    struct PackDirtyState
+    {
+        bool all_shots = false;
+        std::set<int> shots;
+    };
+    PackTable<PackDirtyState> dirty_packs_;
+    // Record bytes re-encoded vs. written by the last save, and re-encoded over the plugin's lifetime.
+    size_t last_save_encoded_bytes_ = 0;
+    size_t last_save_record_bytes_ = 0;
+    uint64_t total_encoded_bytes_ = 0;
+    // All file writes happen on this thread; game hooks only hand it a snapshot.
+    std::unique_ptr<PersistenceWriter> persistence_writer_;
+    // Attempts since the last snapshot are appended here and folded back in on load, unload, or past the threshold.
+    std::string journalFilePath_;
+    size_t journal_bytes_ = 0;
+    static constexpr size_t JOURNAL_COMPACT_BYTES = 64 * 1024;
+    // Attempts not yet handed to the writer, all for pending_history_pack_. Appended to the pack's history log
+    // as one frame when the batch fills up, the pack changes, the log is read, or the plugin unloads.
+    std::vector<AttemptHistory::AttemptRecord> pending_history_;
+    PackId pending_history_pack_ = INVALID_PACK_ID;
+    static constexpr size_t HISTORY_BATCH_ATTEMPTS = 32;
+    // Good versions kept of every snapshot file (current + older), for recovery from a torn or corrupt write.
+    static constexpr int SNAPSHOT_GENERATIONS = 3;
 
     // Persistence methods use string serialization
     void LoadPersistentStats();
+    // Pre-shard single-file formats (binary snapshot, then 6/7-segment text); only read for migration.
+    void LoadMonolithicStats(PersistentData& out);
+    // Renames the single-file formats to *.migrated once their packs are safely in shards.
+    void RetireMonolithicFiles();
+    // Returns the pack's lifetime stats, reading its shard the first time the pack is used.
+    // Each pack is heap-allocated, so the reference (and the session's view into it) survives later inserts.
+    ShotPackStats& EnsurePackLoaded(PackId id);
+    // Marks a shot dirty if its lifetime block changed since the last commit; returns whether it did.
+    bool CommitShot(int shot_index);
+    void MarkShotDirty(PackId pack, int shot_index);
+    void MarkPackDirty(PackId pack);
+    void LogParseReport(const std::string& source, const StatsParseReport& report);
     void SavePersistentStats();
-    void UpdateLifetimeBest(ShotStats& current_stats);
+    void LogWriterMessages();
+    // Records one shot's lifetime state in the journal (O(1) per attempt).
+    void AppendJournalEntry(int shot_index, const ShotLifetimeStats& stats);
+    void FlushAttemptHistory();
+    // ct_history: per-shot totals from the current pack's full attempt history.
+    void LogAttemptHistory();
     std::string GetCurrentPackID();
     // NEW: Helper to get the total number of shots for index correction
     int GetTotalRounds();
@@ -72,50 +111,133 @@ private:
     // ?? NEW: Method to clear lifetime stats for the current pack
     void ClearLifetimeStats();
 
-    // Game event hooks
-    void OnGoalScored(void* params);
-    void OnShotReset(ActorWrapper caller, void* params, std::string eventName);
-    void OnBallExploded(void* params);
-    void OnPlaylistIndexChanged(ActorWrapper caller, void* params, std::string eventName);
-    void OnShotAttempt(void* params);
+    // What a game hook recorded, applied later (and in hook order) by ProcessGameEvents.
+    struct GameEvent
+    {
+        enum class Type : uint8_t { SessionStarted, ShotAttempt, GoalScored, ShotReset, BallExploded, PlaylistIndexChanged };
+        Type type = Type::SessionStarted;
+        int32_t value = 0; // PlaylistIndexChanged: the index as reported by the game, before wrap-around correction
+        std::chrono::steady_clock::time_point time;
+        BoostTicks boost_total = 0; // boost_total_ when the hook fired
+    };
+    // Called from the hooks: no stat work, logging or allocation, just one slot in game_events_.
+    void PushGameEvent(GameEvent::Type type, int32_t value = 0);
+    // Applies every queued event; runs once per frame from RenderWindow, and on unload.
+    void ProcessGameEvents();
+
+    // Game event handlers
+    void OnGoalScored(const GameEvent& event);
+    void OnShotReset(const GameEvent& event);
+    void OnBallExploded(const GameEvent& event);
+    void OnPlaylistIndexChanged(const GameEvent& event);
+    void OnShotAttempt(const GameEvent& event);
 
     // Boost usage tracking hook
-    void OnSetVehicleInput(std::string eventName);
-
+    void OnSetVehicleInput(const std::string& eventName);
+    // Installs OnSetVehicleInput only while the plugin is enabled and a training session is live, removes it otherwise.
+    void UpdateVehicleInputHook(bool in_training);
+    // Recomputes attempt_armed_ and armed_car_; called from every event that can change them, never per tick.
+    void UpdateAttemptArmed();
+
+    // ct_boost_mode: Ticks counts boosting SetVehicleInput ticks; Deltas sums decreases of the car's boost amount
+    // between attempt start, refills and the outcome, and needs no per-tick hook unless it has to fall back.
+    enum class BoostMeasureMode { Ticks = 0, Deltas = 1 };
+    void SetBoostMeasureMode(BoostMeasureMode mode);
+    // Local car's boost in boost units (0-100); false without a car, a boost component, or with unlimited boost.
+    bool ReadBoostAmount(float& amount, std::uintptr_t& component);
+    void OnBoostRefill(ActorWrapper caller, bool before);
+    // Adds what the meter measured so far to boost_total_ and arms the per-tick hook.
+    void FallBackToBoostTicks();
+    // Called from the attempt-start hook: restarts the meter from the current amount (Deltas mode).
+    void StartBoostMeasurement();
+    // Called from the outcome hooks: adds what the meter measured since the attempt started to boost_total_.
+    void SettleBoostMeasurement();
+
+    // TrainerHost
+    void OnAttemptStateChanged() override;
+    void RepeatCurrentShot() override;
+    void RecordAttempt(const AttemptHistory::AttemptRecord& record) override;
+    void CommitLifetime(int shot_index, const ShotLifetimeStats& lifetime) override;
 
-    // Core logic
-    bool IsShotFrozen();
-    void HandleAttempt(bool isSuccess);
     void InitializeSessionStats();
     void ResetSessionStats();
-    // NEW: Helper to reset session stats for the current shot
-    void ResetCurrentShotSessionStats(ShotStats& stats);
     bool IsInValidTraining();
-    void RepeatCurrentShot();
 
     // Plugin state
     bool is_plugin_enabled_ = false;
-    int max_attempts_per_shot_ = 10;
-    int current_shot_index_ = 0;
-    bool plugin_initiated_reset_ = false;
-
-    // Boost tracker for the current attempt
-    float current_attempt_boost_used_ = 0.0f;
+    // Attempt state machine and session stats (SDK-independent)
+    TrainerCore core_{ *this };
+
+    // SetVehicleInput runs on every input tick in every mode, so it is only hooked while needed.
+    bool vehicle_input_hooked_ = false;
+    // An unhook queued from inside the hook (outside training) that has not run yet; later ticks do not queue another.
+    bool vehicle_input_unhook_pending_ = false;
+    uint64_t vehicle_input_hook_installs_ = 0;
+    uint64_t vehicle_input_calls_ = 0;
+    uint64_t vehicle_input_calls_outside_training_ = 0; // Expected to stay 0 (ct_hook_stats)
+    // Everything OnSetVehicleInput used to check per tick (enabled, in training, session loaded, car present).
+    bool attempt_armed_ = false;
+    CarWrapper armed_car_{ 0 };
+
+    // A frame rarely sees more than a handful of events; a full ring drops (and counts) the newest.
+    SpscRing<GameEvent, 256> game_events_;
+    uint64_t game_events_processed_ = 0;
+
+#if CT_PERF_STATS
+    // Per-hook latency, printed by ct_perf_dump
+    PerfCounters perf_;
+    void LogPerfCounters();
+
+    // History behind the diagnostics panel in RenderSettings. Sampled on the game thread from RenderWindow, drawn on
+    // the render thread; every buffer is fixed-size, so neither side allocates per frame.
+    struct Diagnostics
+    {
+        // Per frame
+        PlotRing<256> render_window_us;
+        PlotRing<256> queued_game_events;
+        PlotRing<256> queued_log_lines;
+        // Per completed save (writer thread timing)
+        PlotRing<64> save_ms;
+        PlotRing<64> save_kb;
+        // Per second
+        PlotRing<60> vehicle_input_per_second;
+        PlotRing<60> game_events_per_second;
+        PlotRing<60> log_lines_per_second;
+
+        uint64_t last_render_window_ns = 0;
+        uint64_t last_save_count = 0;
+        uint64_t log_lines = 0;
+        std::chrono::steady_clock::time_point rate_window_start;
+        uint64_t rate_vehicle_input_calls = 0;
+        uint64_t rate_game_events = 0;
+        uint64_t rate_log_lines = 0;
+    };
+    Diagnostics diagnostics_;
+    void SampleDiagnostics(size_t queued_game_events, size_t drained_log_lines);
+    void RenderDiagnostics();
+#endif
+
+    BoostMeasureMode boost_mode_ = BoostMeasureMode::Ticks;
+    BoostDeltaMeter boost_meter_;
+    // Deltas mode only: this attempt is counted in ticks (unlimited boost, or a refill the meter could not bracket).
+    bool boost_tick_fallback_ = false;
+    // Boost measured since load, in ticks, from whichever source is active; it only grows. Game events carry its
+    // value at hook time and TrainerCore charges each attempt the difference between its start and outcome.
+    BoostTicks boost_total_ = 0;
 
     // Stat Toggle States
     bool show_consistency_stats_ = true;
     bool show_boost_stats_ = false;
 
-    // The container for ALL lifetime data
-    PersistentData global_pack_stats_;
+    // Lifetime data for the packs opened this session (others stay on disk until EnsurePackLoaded)
+    PackTable<std::unique_ptr<ShotPackStats>> global_pack_stats_;
     std::string current_pack_id_ = "";
+    // current_pack_id_ interned once per StartPlayTest (INVALID_PACK_ID outside a pack)
+    PackId current_pack_ = INVALID_PACK_ID;
 
     // GUI Window state
     bool is_window_open_ = false;
     int text_pos_x_ = 100;
     int text_pos_y_ = 200;
     float text_scale_ = 2.0f;
-
-    // Map to store stats for each shot index (Local Session)
-    std::map<int, ShotStats> training_session_stats_;
 };
@@ -0,0 +1,98 @@
+#include "Crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CT_CRC32C_X86 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+    constexpr uint32_t POLYNOMIAL = 0x82F63B78u; // Reflected Castagnoli polynomial
+
+    constexpr std::array<uint32_t, 256> MakeTable()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1u) ? POLYNOMIAL : 0u);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> TABLE = MakeTable();
+
+    uint32_t Crc32cSoftware(const uint8_t* p, size_t size, uint32_t crc)
+    {
+        while (size--) {
+            crc = TABLE[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#ifdef CT_CRC32C_X86
+    bool CpuHasSse42()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+        return (ecx & bit_SSE4_2) != 0;
+#endif
+    }
+
+#ifndef _MSC_VER
+    __attribute__((target("sse4.2")))
+#endif
+    uint32_t Crc32cHardware(const uint8_t* p, size_t size, uint32_t crc)
+    {
+        uint64_t crc64 = crc;
+        while (size >= sizeof(uint64_t)) {
+            uint64_t chunk;
+            std::memcpy(&chunk, p, sizeof(chunk));
+            crc64 = _mm_crc32_u64(crc64, chunk);
+            p += sizeof(chunk);
+            size -= sizeof(chunk);
+        }
+        uint32_t crc32 = static_cast<uint32_t>(crc64);
+        while (size--) {
+            crc32 = _mm_crc32_u8(crc32, *p++);
+        }
+        return crc32;
+    }
+
+    const bool HAS_HARDWARE_CRC = CpuHasSse42();
+#else
+    const bool HAS_HARDWARE_CRC = false;
+#endif
+}
+
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+#ifdef CT_CRC32C_X86
+    if (HAS_HARDWARE_CRC) {
+        return ~Crc32cHardware(p, size, crc);
+    }
+#endif
+    return ~Crc32cSoftware(p, size, crc);
+}
+
+bool Crc32cIsHardwareAccelerated()
+{
+    return HAS_HARDWARE_CRC;
+}
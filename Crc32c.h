@@ -0,0 +1,12 @@
+#pragma once
+
+// CRC-32C (Castagnoli). Uses the SSE4.2 crc32 instruction when the CPU has it, a lookup table otherwise.
+
+#include <cstddef>
+#include <cstdint>
+
+// Pass a previous result as `crc` to continue a running checksum over several buffers.
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+// True if Crc32c is using the hardware instruction on this machine.
+bool Crc32cIsHardwareAccelerated();
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class LogLevel : uint8_t { Debug = 0, Info = 1, Warning = 2, Error = 3, Off = 4 };
+
+// Bounded queue of preformatted log lines. Any thread may push (hooks, the settings window, the writer); one thread
+// drains. Pushing never blocks or allocates: a full ring drops the line and counts it, a long line is cut to fit.
+template <size_t Capacity, size_t TextSize>
+class LogRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    LogRing()
+    {
+        for (size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryPush(LogLevel level, std::string_view text)
+    {
+        // Each slot's sequence says whose turn it is: == position when free for that push, position + 1 once written.
+        size_t position = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[position & (Capacity - 1)];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (lag == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (lag < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        if (text.size() > TextSize) {
+            text = text.substr(0, TextSize);
+            truncated_.fetch_add(1, std::memory_order_relaxed);
+        }
+        slot->level = level;
+        slot->length = static_cast<uint16_t>(text.size());
+        std::copy(text.begin(), text.end(), slot->text.data());
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Hands every completed line to `fn(level, text)` in push order; the view is only valid during the call.
+    template <typename Fn>
+    size_t Drain(Fn&& fn)
+    {
+        size_t count = 0;
+        for (;;) {
+            Slot& slot = slots_[tail_ & (Capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) break;
+            fn(slot.level, std::string_view(slot.text.data(), slot.length));
+            slot.sequence.store(tail_ + Capacity, std::memory_order_release);
+            tail_++;
+            count++;
+        }
+        return count;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+    uint64_t DroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t TruncatedCount() const { return truncated_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{ 0 };
+        LogLevel level = LogLevel::Info;
+        uint16_t length = 0;
+        std::array<char, TextSize> text;
+    };
+    static_assert(TextSize <= UINT16_MAX, "TextSize must fit the length field");
+
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    alignas(64) size_t tail_ = 0;
+    alignas(64) std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<uint64_t> truncated_{ 0 };
+    std::array<Slot, Capacity> slots_;
+};
@@ -0,0 +1,307 @@
+#include "PackShardStore.h"
+#include "Crc32c.h"
+#include "MappedFile.h"
+#include "PersistenceWriter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <system_error>
+
+PackShardStore::PackShardStore(std::string directory, int generations)
+    : directory_(std::move(directory)), generations_(generations < 1 ? 1 : generations)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+}
+
+bool PackShardStore::LoadIndex(std::string& warning)
+{
+    ids_.clear();
+    names_.clear();
+    next_id_ = 0;
+    has_index_ = false;
+    index_dirty_ = false;
+    warning.clear();
+
+    // Same recovery as the shards: the newest generation that passes its checksum wins.
+    std::string first_error;
+    bool any_file = false;
+    for (int generation = 0; generation < generations_; ++generation) {
+        MappedFile file;
+        if (!file.Open(PersistenceWriter::GenerationPath(GetIndexPath(), generation))) {
+            continue;
+        }
+        any_file = true;
+
+        std::string error;
+        if (!ParseIndex(std::string_view(reinterpret_cast<const char*>(file.Data()), file.Size()), warning, error)) {
+            if (first_error.empty()) first_error = error;
+            continue;
+        }
+        if (generation > 0) {
+            warning = "index.txt " + (first_error.empty() ? std::string("missing") : "unreadable (" + first_error + ")")
+                + ", using generation " + std::to_string(generation);
+            index_dirty_ = true;
+            // Packs added after this generation was written still have their shards on disk.
+            next_id_ = std::max(next_id_, FirstUnusedShardNumber());
+        }
+        has_index_ = true;
+        return true;
+    }
+
+    if (any_file) {
+        warning = "no readable index.txt generation (" + first_error + ")";
+    }
+    // Without an index, new IDs must still not reuse the number of a shard (or history) left on disk.
+    next_id_ = FirstUnusedShardNumber();
+    return false;
+}
+
+bool PackShardStore::ParseIndex(std::string_view text, std::string& warning, std::string& error)
+{
+    ids_.clear();
+    names_.clear();
+    next_id_ = 0;
+
+    // "#ctindex <version> <crc32c hex> <body bytes>" then the body. Indexes written before the header was added
+    // have none and are accepted unchecked, but an empty file can only be a torn write.
+    if (text.empty()) {
+        error = "empty file";
+        return false;
+    }
+    if (text.substr(0, INDEX_MAGIC.size()) == INDEX_MAGIC) {
+        const size_t header_end = text.find('\n');
+        if (header_end == std::string_view::npos) {
+            error = "truncated header";
+            return false;
+        }
+        const char* cursor = text.data() + INDEX_MAGIC.size();
+        const char* end = text.data() + header_end;
+        int version = 0;
+        uint32_t crc = 0;
+        size_t body_bytes = 0;
+        auto parse = [&](auto& value, int base) {
+            while (cursor < end && *cursor == ' ') ++cursor;
+            auto [ptr, ec] = std::from_chars(cursor, end, value, base);
+            cursor = ptr;
+            return ec == std::errc();
+        };
+        if (!parse(version, 10) || !parse(crc, 16) || !parse(body_bytes, 10) || cursor != end) {
+            error = "malformed header";
+            return false;
+        }
+        if (version != INDEX_VERSION) {
+            error = "unsupported version " + std::to_string(version);
+            return false;
+        }
+        text.remove_prefix(header_end + 1);
+        if (text.size() != body_bytes) {
+            error = "expected " + std::to_string(body_bytes) + " bytes, found " + std::to_string(text.size());
+            return false;
+        }
+        if (Crc32c(text.data(), text.size()) != crc) {
+            error = "checksum mismatch";
+            return false;
+        }
+    }
+
+    int line_number = 0;
+    while (!text.empty()) {
+        const size_t line_end = text.find('\n');
+        std::string_view line = text.substr(0, line_end);
+        text.remove_prefix(line_end == std::string_view::npos ? text.size() : line_end + 1);
+        line_number++;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+
+        // The pack ID is last, so it may itself contain '|'.
+        size_t separator = line.find('|');
+        if (separator == std::string_view::npos) separator = line.size();
+        int shard = -1;
+        auto [ptr, ec] = std::from_chars(line.data(), line.data() + separator, shard);
+        if (separator == line.size() || ec != std::errc() || ptr != line.data() + separator || shard < 0) {
+            warning = "skipped malformed index line " + std::to_string(line_number);
+            continue;
+        }
+
+        std::string name(line.substr(separator + 1));
+        ids_[name] = static_cast<PackId>(shard);
+        names_[static_cast<PackId>(shard)] = std::move(name);
+        if (static_cast<PackId>(shard) >= next_id_) next_id_ = static_cast<PackId>(shard) + 1;
+    }
+    return true;
+}
+
+bool PackShardStore::LoadShard(PackId id, ShotPackStats& out, int& generation, std::string& error)
+{
+    out.clear();
+    generation = 0;
+    error.clear();
+
+    const std::string path = GetShardPath(id);
+    std::string first_error;
+    bool any_file = false;
+    for (generation = 0; generation < generations_; ++generation) {
+        MappedFile file;
+        if (!file.Open(PersistenceWriter::GenerationPath(path, generation))) {
+            continue;
+        }
+        any_file = true;
+
+        // Every shard is written with a header, so an empty file is a torn or truncated write like any other.
+        PersistentData decoded;
+        std::string decode_error;
+        if (!StatsBinary::Decode(file.Data(), file.Size(), decoded, decode_error)) {
+            if (first_error.empty()) first_error = decode_error;
+            continue;
+        }
+
+        // A shard holds a single pack, stored under its name. A file under this ID that names another pack
+        // (e.g. IDs reassigned after the index was lost) must not be loaded as this one.
+        auto pack = decoded.find(GetName(id));
+        if (decoded.size() != 1 || pack == decoded.end()) {
+            if (first_error.empty()) {
+                first_error = decoded.empty() ? "shard holds no pack"
+                    : "shard holds pack '" + decoded.begin()->first + "', not '" + GetName(id) + "'";
+            }
+            continue;
+        }
+        out = std::move(pack->second);
+
+        // Re-encoding is deterministic, so this matches the bytes on disk.
+        encoded_[id].clear();
+        UpdateEncoding(id, out, nullptr);
+        error = first_error;
+        return true;
+    }
+
+    generation = 0;
+    if (!any_file) {
+        // Interned but never saved (or the files were removed): the pack simply starts empty.
+        encoded_[id].clear();
+        return true;
+    }
+    error = first_error;
+    return false;
+}
+
+PackId PackShardStore::FirstUnusedShardNumber() const
+{
+    PackId next = 0;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+        // "<n>.bin", "<n>.hist" and their generations "<n>.bin.1", ...
+        const std::string name = entry.path().filename().string();
+        PackId shard = 0;
+        auto [ptr, parse_ec] = std::from_chars(name.data(), name.data() + name.size(), shard);
+        if (parse_ec == std::errc() && ptr != name.data() && *ptr == '.' && shard >= next) {
+            next = shard + 1;
+        }
+    }
+    return next;
+}
+
+PackId PackShardStore::Intern(const std::string& pack_name)
+{
+    auto it = ids_.find(pack_name);
+    if (it == ids_.end()) {
+        it = ids_.emplace(pack_name, next_id_).first;
+        names_[next_id_] = pack_name;
+        next_id_++;
+        index_dirty_ = true;
+    }
+    return it->second;
+}
+
+bool PackShardStore::Find(const std::string& pack_name, PackId& id) const
+{
+    auto it = ids_.find(pack_name);
+    if (it == ids_.end()) return false;
+    id = it->second;
+    return true;
+}
+
+const std::string& PackShardStore::GetName(PackId id) const
+{
+    static const std::string unknown;
+    auto it = names_.find(id);
+    return it != names_.end() ? it->second : unknown;
+}
+
+std::string PackShardStore::GetShardPath(PackId id) const
+{
+    return (std::filesystem::path(directory_) / (std::to_string(id) + ".bin")).string();
+}
+
+std::string PackShardStore::GetHistoryPath(PackId id) const
+{
+    return (std::filesystem::path(directory_) / (std::to_string(id) + ".hist")).string();
+}
+
+std::string PackShardStore::GetIndexPath() const
+{
+    return (std::filesystem::path(directory_) / "index.txt").string();
+}
+
+std::string PackShardStore::EncodeIndex() const
+{
+    std::string body;
+    for (const auto& entry : ids_) {
+        body += std::to_string(entry.second);
+        body += '|';
+        body += entry.first;
+        body += '\n';
+    }
+
+    char crc[9];
+    const auto crc_end = std::to_chars(crc, crc + sizeof(crc), Crc32c(body.data(), body.size()), 16).ptr;
+    std::string out(INDEX_MAGIC);
+    out += ' ';
+    out += std::to_string(INDEX_VERSION);
+    out += ' ';
+    out.append(crc, crc_end);
+    out += ' ';
+    out += std::to_string(body.size());
+    out += '\n';
+    out += body;
+    return out;
+}
+
+size_t PackShardStore::UpdateEncoding(PackId id, const ShotPackStats& stats, const std::set<int>* changed_shots)
+{
+    auto cached = encoded_.find(id);
+    if (cached == encoded_.end() || changed_shots == nullptr) {
+        std::map<int, StatsBinary::EncodedRecord>& records = encoded_[id];
+        records.clear();
+        for (const auto& shot_pair : stats) {
+            StatsBinary::EncodeRecord(records[shot_pair.first], shot_pair.first, shot_pair.second);
+        }
+        return stats.size() * StatsBinary::RECORD_SIZE;
+    }
+
+    size_t bytes = 0;
+    for (int shot_index : *changed_shots) {
+        auto shot = stats.find(shot_index);
+        if (shot == stats.end()) {
+            cached->second.erase(shot_index);
+            continue;
+        }
+        StatsBinary::EncodeRecord(cached->second[shot_index], shot_index, shot->second);
+        bytes += StatsBinary::RECORD_SIZE;
+    }
+    return bytes;
+}
+
+std::vector<StatsBinary::EncodedRecord> PackShardStore::GetEncodedRecords(PackId id) const
+{
+    std::vector<StatsBinary::EncodedRecord> out;
+    auto cached = encoded_.find(id);
+    if (cached == encoded_.end()) return out;
+
+    out.reserve(cached->second.size());
+    for (const auto& record : cached->second) {
+        out.push_back(record.second);
+    }
+    return out;
+}
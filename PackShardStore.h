@@ -0,0 +1,82 @@
+#pragma once
+
+// One binary shard file per training pack, plus a small text index mapping pack IDs to shard files.
+//
+// Directory layout:
+//   index.txt   "#ctindex <version> <CRC-32C hex> <body bytes>" header, then one "<shard number>|<pack id>" line
+//               per pack (the pack name string table, see Intern)
+//   <n>.bin     StatsBinaryFormat snapshot holding that single pack
+//   <n>.hist    append-only attempt history for the same pack (AttemptHistory.h)
+//   *.1, *.2    older generations kept by PersistenceWriter, used when the current file is torn or corrupt
+//
+// The store only reads from disk; writes are handed to PersistenceWriter as encoded snapshots.
+
+#include "ShotStats.h"
+#include "StatsBinaryFormat.h"
+#include "PackTable.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class PackShardStore
+{
+public:
+    PackShardStore(std::string directory, int generations);
+
+    // Reads index.txt, falling back to older generations if the current one is empty, torn or fails its checksum.
+    // Returns false if no generation is readable (fresh install, pre-shard data to migrate, or all lost).
+    // `warning` describes skipped lines or the generation used, if any.
+    bool LoadIndex(std::string& warning);
+
+    bool HasIndex() const { return has_index_; }
+    size_t GetPackCount() const { return ids_.size(); }
+
+    // The index doubles as the pack name string table: a pack's ID is its shard number, so each name is
+    // stored once on disk and everything else refers to the pack by ID.
+    // Returns the pack's ID, assigning the next free one (and dirtying the index) the first time.
+    PackId Intern(const std::string& pack_name);
+    bool Find(const std::string& pack_name, PackId& id) const;
+    const std::string& GetName(PackId id) const;
+
+    // Maps and decodes one pack's shard, and seeds the pack's encoding cache from it. A pack with no shard yet
+    // loads empty. Falls back to older generations if the current file fails its checksum or holds a pack under
+    // a different name; `generation` reports which one loaded.
+    bool LoadShard(PackId id, ShotPackStats& out, int& generation, std::string& error);
+
+    std::string GetShardPath(PackId id) const;
+    std::string GetHistoryPath(PackId id) const;
+
+    bool IsIndexDirty() const { return index_dirty_; }
+    void MarkIndexClean() { index_dirty_ = false; }
+    std::string GetIndexPath() const;
+    std::string EncodeIndex() const;
+
+    // Brings the pack's cached record encodings up to date and returns how many bytes were encoded.
+    // Only `changed_shots` are re-encoded; pass nullptr (or use a pack with no cache yet) to encode every shot.
+    size_t UpdateEncoding(PackId id, const ShotPackStats& stats, const std::set<int>* changed_shots);
+    std::vector<StatsBinary::EncodedRecord> GetEncodedRecords(PackId id) const;
+    void ForgetEncodings() { encoded_.clear(); }
+
+private:
+    static constexpr std::string_view INDEX_MAGIC = "#ctindex";
+    static constexpr int INDEX_VERSION = 1;
+
+    // Replaces the ID maps with the index in `text`; false (with `error`) if it is empty or fails its header check.
+    bool ParseIndex(std::string_view text, std::string& warning, std::string& error);
+    // One past the highest shard number of any file in the directory.
+    PackId FirstUnusedShardNumber() const;
+
+    std::string directory_;
+    int generations_ = 1;
+    std::map<std::string, PackId> ids_;
+    std::map<PackId, std::string> names_;
+    PackId next_id_ = 0;
+    bool has_index_ = false;
+    bool index_dirty_ = false;
+
+    // Game thread only: last encoding of every record of each pack that has been loaded or saved.
+    PackTable<std::map<int, StatsBinary::EncodedRecord>> encoded_;
+};
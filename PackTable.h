@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Compact ID of an interned training pack name (PackShardStore::Intern). IDs are small and stable across restarts.
+using PackId = uint32_t;
+constexpr PackId INVALID_PACK_ID = UINT32_MAX;
+
+// Open-addressing hash table (linear probing) from PackId to T, for everything the game thread keys by pack.
+// Same interface subset as std::map: operator[] inserts a default value, iteration yields (id, value) pairs
+// in no particular order. Entries are never erased individually, only all at once by clear().
+// Inserting a new ID may rehash, which invalidates references and iterators into the table.
+template <typename T>
+class PackTable
+{
+public:
+    using value_type = std::pair<PackId, T>; // `first` is the pack ID; do not modify it through an iterator
+
+    template <typename Slot>
+    class BasicIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename PackTable::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Slot*;
+        using reference = Slot&;
+
+        BasicIterator() = default;
+        BasicIterator(Slot* slot, Slot* end) : slot_(slot), end_(end) { SkipEmpty(); }
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+        BasicIterator& operator++() { ++slot_; SkipEmpty(); return *this; }
+        BasicIterator operator++(int) { BasicIterator old = *this; ++*this; return old; }
+        bool operator==(const BasicIterator& other) const { return slot_ == other.slot_; }
+        bool operator!=(const BasicIterator& other) const { return slot_ != other.slot_; }
+
+    private:
+        void SkipEmpty() { while (slot_ != end_ && slot_->first == INVALID_PACK_ID) ++slot_; }
+
+        Slot* slot_ = nullptr;
+        Slot* end_ = nullptr;
+    };
+    using iterator = BasicIterator<value_type>;
+    using const_iterator = BasicIterator<const value_type>;
+
+    // Looking up an ID that is present never rehashes; only inserting one that is not may grow the table.
+    T& operator[](PackId id)
+    {
+        size_t i = slots_.empty() ? 0 : Probe(id);
+        if (!slots_.empty() && slots_[i].first == id) return slots_[i].second;
+
+        if (slots_.empty() || (count_ + 1) * 4 > slots_.size() * 3) {
+            Rehash(slots_.empty() ? INITIAL_CAPACITY : slots_.size() * 2);
+            i = Probe(id);
+        }
+        value_type& slot = slots_[i];
+        slot.first = id;
+        slot.second = T();
+        count_++;
+        return slot.second;
+    }
+
+    iterator find(PackId id)
+    {
+        if (slots_.empty()) return end();
+        value_type& slot = slots_[Probe(id)];
+        return slot.first == id ? iterator(&slot, EndSlot()) : end();
+    }
+    const_iterator find(PackId id) const
+    {
+        if (slots_.empty()) return end();
+        const value_type& slot = slots_[Probe(id)];
+        return slot.first == id ? const_iterator(&slot, EndSlot()) : end();
+    }
+    size_t count(PackId id) const { return find(id) != end() ? 1 : 0; }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    // Keeps the allocation.
+    void clear()
+    {
+        for (value_type& slot : slots_) {
+            slot.first = INVALID_PACK_ID;
+            slot.second = T();
+        }
+        count_ = 0;
+    }
+
+    iterator begin() { return iterator(slots_.data(), EndSlot()); }
+    iterator end() { return iterator(EndSlot(), EndSlot()); }
+    const_iterator begin() const { return const_iterator(slots_.data(), EndSlot()); }
+    const_iterator end() const { return const_iterator(EndSlot(), EndSlot()); }
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = 16; // Power of two; capacity always stays one
+
+    // Slot holding `id`, or the empty slot where it would go. The table always has at least one empty slot.
+    size_t Probe(PackId id) const
+    {
+        const size_t mask = slots_.size() - 1;
+        size_t i = (static_cast<size_t>(id) * 0x9E3779B1u) & mask; // Fibonacci hashing spreads consecutive IDs
+        while (slots_[i].first != id && slots_[i].first != INVALID_PACK_ID) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        std::vector<value_type> old;
+        old.swap(slots_);
+        // Filled in place rather than from a prototype slot so move-only values work too.
+        slots_.resize(capacity);
+        for (value_type& slot : slots_) {
+            slot.first = INVALID_PACK_ID;
+        }
+        for (value_type& slot : old) {
+            if (slot.first != INVALID_PACK_ID) {
+                slots_[Probe(slot.first)] = std::move(slot);
+            }
+        }
+    }
+
+    value_type* EndSlot() { return slots_.data() + slots_.size(); }
+    const value_type* EndSlot() const { return slots_.data() + slots_.size(); }
+
+    std::vector<value_type> slots_;
+    size_t count_ = 0;
+};
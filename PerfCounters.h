@@ -0,0 +1,188 @@
+#pragma once
+
+// Per-hook call counts and latency histograms (ct_perf_dump). Build with CT_PERF_STATS=0 to compile all of it out:
+// CT_PERF_SCOPE then expands to nothing and PerfCounters is not declared.
+#ifndef CT_PERF_STATS
+#define CT_PERF_STATS 1
+#endif
+
+#if CT_PERF_STATS
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+enum class PerfHook : uint8_t
+{
+    SetVehicleInput,
+    GoalScored,
+    ShotReset,
+    BallExploded,
+    ShotAttempt,
+    PlaylistIndexChanged,
+    RenderWindow,
+    RenderSettings,
+    SavePersistentStats,
+    Count
+};
+
+inline const char* PerfHookName(PerfHook hook)
+{
+    static constexpr const char* names[] = {
+        "OnSetVehicleInput", "OnGoalScored", "OnShotReset", "OnBallExploded", "OnShotAttempt",
+        "OnPlaylistIndexChanged", "RenderWindow", "RenderSettings", "SavePersistentStats",
+    };
+    static_assert(std::size(names) == static_cast<size_t>(PerfHook::Count));
+    return names[static_cast<size_t>(hook)];
+}
+
+// Log-linear histogram of nanosecond latencies: each power of two is split into 4 buckets, so a percentile read
+// back from it is within 25% of the true value. Recording is two relaxed atomic adds, safe from any thread
+// (RenderSettings records from the render thread, everything else from the game thread).
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKETS = 4;
+    // Enough for anything below 2^40 ns (about 18 minutes); longer calls land in the last bucket.
+    static constexpr size_t BUCKETS = 40 * SUB_BUCKETS;
+
+    void Record(uint64_t ns)
+    {
+        buckets_[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        total_ns_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = max_ns_.load(std::memory_order_relaxed);
+        while (ns > max && !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+
+    // The call count is the bucket sum, which keeps Record down to two atomic adds.
+    uint64_t Count() const
+    {
+        uint64_t count = 0;
+        for (const auto& bucket : buckets_) count += bucket.load(std::memory_order_relaxed);
+        return count;
+    }
+    uint64_t TotalNs() const { return total_ns_.load(std::memory_order_relaxed); }
+    uint64_t MaxNs() const { return max_ns_.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the given quantile (0-1); 0 with no samples.
+    uint64_t PercentileNs(double quantile) const
+    {
+        const uint64_t count = Count();
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(count - 1)) + 1;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            const uint64_t in_bucket = buckets_[i].load(std::memory_order_relaxed);
+            if (rank <= in_bucket) return std::min(BucketUpperNs(i), MaxNs());
+            rank -= in_bucket;
+        }
+        return MaxNs();
+    }
+
+    void Reset()
+    {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+        total_ns_.store(0, std::memory_order_relaxed);
+        max_ns_.store(0, std::memory_order_relaxed);
+    }
+
+    static size_t BucketIndex(uint64_t ns)
+    {
+        if (ns < SUB_BUCKETS) return static_cast<size_t>(ns);
+        const int msb = std::bit_width(ns) - 1;
+        const size_t index = static_cast<size_t>(msb - 1) * SUB_BUCKETS + ((ns >> (msb - 2)) & (SUB_BUCKETS - 1));
+        return index < BUCKETS ? index : BUCKETS - 1;
+    }
+
+    static uint64_t BucketUpperNs(size_t index)
+    {
+        if (index < SUB_BUCKETS) return index + 1;
+        const int msb = static_cast<int>(index / SUB_BUCKETS) + 1;
+        return (SUB_BUCKETS + index % SUB_BUCKETS + 1) << (msb - 2);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> total_ns_{ 0 };
+    std::atomic<uint64_t> max_ns_{ 0 };
+};
+
+// Per-tick hooks time only 1 in this many calls: two clock reads cost more than the hook body itself.
+inline constexpr uint64_t PERF_SAMPLE_EVERY = 64;
+
+class PerfCounters
+{
+public:
+    LatencyHistogram& operator[](PerfHook hook) { return histograms_[static_cast<size_t>(hook)]; }
+    const LatencyHistogram& operator[](PerfHook hook) const { return histograms_[static_cast<size_t>(hook)]; }
+
+    // Every call to a hook timed with CT_PERF_SCOPE_SAMPLED (its histogram only sees the sampled ones); 0 for the
+    // others. Written from the hook's own thread only.
+    uint64_t& SampledCalls(PerfHook hook) { return sampled_calls_[static_cast<size_t>(hook)]; }
+    uint64_t SampledCalls(PerfHook hook) const { return sampled_calls_[static_cast<size_t>(hook)]; }
+
+    void Reset()
+    {
+        for (auto& histogram : histograms_) histogram.Reset();
+        sampled_calls_.fill(0);
+    }
+
+private:
+    std::array<LatencyHistogram, static_cast<size_t>(PerfHook::Count)> histograms_;
+    std::array<uint64_t, static_cast<size_t>(PerfHook::Count)> sampled_calls_{};
+};
+
+// Records the time from construction to the end of the enclosing scope, nested calls included.
+class PerfScope
+{
+public:
+    explicit PerfScope(LatencyHistogram& histogram) : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~PerfScope()
+    {
+        histogram_.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count()));
+    }
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// PerfScope for call number `call`: only every PERF_SAMPLE_EVERY-th call reads the clock.
+class SampledPerfScope
+{
+public:
+    SampledPerfScope(LatencyHistogram& histogram, uint64_t call) : histogram_(call % PERF_SAMPLE_EVERY == 0 ? &histogram : nullptr)
+    {
+        if (histogram_) start_ = std::chrono::steady_clock::now();
+    }
+    ~SampledPerfScope()
+    {
+        if (!histogram_) return;
+        histogram_->Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count()));
+    }
+    SampledPerfScope(const SampledPerfScope&) = delete;
+    SampledPerfScope& operator=(const SampledPerfScope&) = delete;
+
+private:
+    LatencyHistogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define CT_PERF_CONCAT_INNER(a, b) a##b
+#define CT_PERF_CONCAT(a, b) CT_PERF_CONCAT_INNER(a, b)
+#define CT_PERF_SCOPE(counters, hook) PerfScope CT_PERF_CONCAT(perf_scope_, __LINE__)((counters)[hook])
+#define CT_PERF_SCOPE_SAMPLED(counters, hook) \
+    SampledPerfScope CT_PERF_CONCAT(perf_scope_, __LINE__)((counters)[hook], (counters).SampledCalls(hook)++)
+
+#else
+
+#define CT_PERF_SCOPE(counters, hook) ((void)0)
+#define CT_PERF_SCOPE_SAMPLED(counters, hook) ((void)0)
+
+#endif
@@ -0,0 +1,295 @@
+#include "PersistenceWriter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+PersistenceWriter::PersistenceWriter(std::string journal_path, int generations)
+    : journal_path_(std::move(journal_path)), generations_(generations < 1 ? 1 : generations)
+{
+    thread_ = std::thread(&PersistenceWriter::Run, this);
+}
+
+PersistenceWriter::~PersistenceWriter()
+{
+    Stop();
+}
+
+void PersistenceWriter::RequestSave(std::vector<FileSnapshot> files)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;
+        for (auto& failed : failed_files_) {
+            pending_files_.insert(std::move(failed));
+        }
+        failed_files_.clear();
+        for (FileSnapshot& file : files) {
+            pending_files_[file.path] = std::move(file.contents);
+        }
+        pending_truncate_ = true;
+        superseded_appends_ += pending_appends_;
+        pending_appends_.clear();
+    }
+    wake_.notify_one();
+}
+
+void PersistenceWriter::RequestAppend(std::string entry)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;
+        pending_appends_ += entry;
+    }
+    wake_.notify_one();
+}
+
+void PersistenceWriter::RequestAppendTo(const std::string& path, std::string bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;
+        pending_file_appends_[path] += bytes;
+    }
+    wake_.notify_one();
+}
+
+bool PersistenceWriter::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return !HasPendingWork() && !writing_; });
+    return last_write_ok_;
+}
+
+void PersistenceWriter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ && !thread_.joinable()) return;
+        stopping_ = true;
+    }
+    wake_.notify_one();
+
+    // The thread drains whatever is still pending before it exits.
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::vector<std::string> PersistenceWriter::TakeMessages()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> out;
+    out.swap(messages_);
+    return out;
+}
+
+int PersistenceWriter::GetWriteCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return write_count_;
+}
+
+PersistenceWriter::SaveStats PersistenceWriter::GetSaveStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return save_stats_;
+}
+
+void PersistenceWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return HasPendingWork() || stopping_; });
+
+        if (!HasPendingWork()) {
+            // Stopping with nothing left to write.
+            break;
+        }
+
+        std::map<std::string, SnapshotFn> files;
+        files.swap(pending_files_);
+        bool truncate = pending_truncate_;
+        pending_truncate_ = false;
+        std::string superseded;
+        superseded.swap(superseded_appends_);
+        std::string appends;
+        appends.swap(pending_appends_);
+        std::map<std::string, std::string> file_appends;
+        file_appends.swap(pending_file_appends_);
+        writing_ = true;
+        lock.unlock();
+
+        bool ok = true;
+        const auto save_start = std::chrono::steady_clock::now();
+        size_t save_bytes = 0;
+        std::map<std::string, SnapshotFn> failed;
+        for (auto& file : files) {
+            bool written = false;
+            try {
+                const std::string contents = file.second();
+                save_bytes += contents.size();
+                written = WriteAtomically(file.first, contents);
+            }
+            catch (const std::exception& e) {
+                PushMessage("Error serializing persistent data. Error: " + std::string(e.what()));
+            }
+            if (!written) {
+                failed.insert(std::move(file));
+                ok = false;
+            }
+        }
+        if (!files.empty() && ok) {
+            PushMessage("Saved " + std::to_string(files.size()) + " persistence file(s).");
+        }
+        // If any file failed, keep the journal and add the entries the snapshot was meant to cover, so everything
+        // is replayed on the next load.
+        if (truncate && ok) {
+            ok = TruncateJournal();
+        }
+        else if (!superseded.empty()) {
+            ok = AppendToJournal(superseded) && ok;
+        }
+        const double save_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - save_start).count();
+        if (!appends.empty()) {
+            ok = AppendToJournal(appends) && ok;
+        }
+        for (const auto& append : file_appends) {
+            ok = AppendToFile(append.first, append.second) && ok;
+        }
+
+        lock.lock();
+        for (auto& file : failed) {
+            // A newer snapshot of the same file queued meanwhile supersedes the failed one.
+            if (pending_files_.find(file.first) == pending_files_.end()) failed_files_.insert(std::move(file));
+        }
+        writing_ = false;
+        last_write_ok_ = ok;
+        if (ok) write_count_++;
+        if (!files.empty()) {
+            save_stats_.saves++;
+            save_stats_.last_save_ms = save_ms;
+            save_stats_.last_save_bytes = save_bytes;
+        }
+        idle_.notify_all();
+    }
+    idle_.notify_all();
+}
+
+bool PersistenceWriter::HasPendingWork() const
+{
+    return !pending_files_.empty() || pending_truncate_ || !pending_appends_.empty() || !pending_file_appends_.empty();
+}
+
+std::string PersistenceWriter::GenerationPath(const std::string& path, int generation)
+{
+    return generation == 0 ? path : path + "." + std::to_string(generation);
+}
+
+bool PersistenceWriter::WriteAtomically(const std::string& path, const std::string& contents)
+{
+    namespace fs = std::filesystem;
+
+    const fs::path target(path);
+    fs::path temp = target;
+    temp += ".tmp";
+
+    std::FILE* file = std::fopen(temp.string().c_str(), "wb");
+    if (!file) {
+        PushMessage("Error: Could not open temporary persistence file for writing: " + temp.string());
+        return false;
+    }
+    bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size()
+        && std::fflush(file) == 0
+        && SyncToDisk(file);
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        PushMessage("Error: Write to temporary persistence file failed: " + temp.string());
+        std::error_code ec;
+        fs::remove(temp, ec);
+        return false;
+    }
+
+    // The new contents are durable; shift the older good generations down before replacing the current one.
+    // The current file is copied (not moved) to ".1" so there is never a moment without it.
+    std::error_code ec;
+    if (generations_ > 1 && fs::exists(target, ec)) {
+        for (int generation = generations_ - 1; generation > 1; --generation) {
+            const fs::path older(GenerationPath(path, generation - 1));
+            if (fs::exists(older, ec)) {
+                fs::rename(older, GenerationPath(path, generation), ec);
+            }
+        }
+        fs::copy_file(target, GenerationPath(path, 1), fs::copy_options::overwrite_existing, ec);
+        if (ec) {
+            PushMessage("Warning: Could not keep previous generation of " + path + ". Error: " + ec.message());
+        }
+    }
+
+    // rename() replaces the destination in one step, so a reader never sees a half-written file.
+    fs::rename(temp, target, ec);
+    if (ec) {
+        PushMessage("Error: Could not replace persistence file. Error: " + ec.message());
+        fs::remove(temp, ec);
+        return false;
+    }
+
+    return true;
+}
+
+bool PersistenceWriter::SyncToDisk(std::FILE* file)
+{
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return ::fsync(fileno(file)) == 0;
+#endif
+}
+
+bool PersistenceWriter::TruncateJournal()
+{
+    if (journal_path_.empty()) return true;
+
+    std::ofstream file(journal_path_, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        PushMessage("Error: Could not truncate journal file: " + journal_path_);
+        return false;
+    }
+    return true;
+}
+
+bool PersistenceWriter::AppendToJournal(const std::string& entries)
+{
+    if (journal_path_.empty()) return true;
+    return AppendToFile(journal_path_, entries);
+}
+
+bool PersistenceWriter::AppendToFile(const std::string& path, const std::string& bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        PushMessage("Error: Could not open file for appending: " + path);
+        return false;
+    }
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.flush();
+    if (!file) {
+        PushMessage("Error: Append to file failed: " + path);
+        return false;
+    }
+    return true;
+}
+
+void PersistenceWriter::PushMessage(std::string message)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_.push_back(std::move(message));
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// Background writer for the persistence snapshot files and their append-only journal.
+// Kept free of BakkesMod includes so it can be exercised headlessly (any path, any OS).
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PersistenceWriter
+{
+public:
+    // Produces the full file contents. Runs on the writer thread, so it must only touch data it owns.
+    using SnapshotFn = std::function<std::string()>;
+
+    struct FileSnapshot
+    {
+        std::string path;
+        SnapshotFn contents;
+    };
+
+    // `generations` is how many good versions of each file to keep: the file itself plus "<path>.1" ... "<path>.N-1".
+    explicit PersistenceWriter(std::string journal_path, int generations = 1);
+    ~PersistenceWriter();
+
+    PersistenceWriter(const PersistenceWriter&) = delete;
+    PersistenceWriter& operator=(const PersistenceWriter&) = delete;
+
+    // Queue a save of one or more files, each replaced atomically. A pending write to the same path is replaced,
+    // so a burst of requests results in a single write per file.
+    // Journal entries queued before the save are only dropped once the snapshot (which contains them) is on disk,
+    // and the journal file is truncated at that point. If a file fails, those entries are appended to the journal
+    // instead and the file is retried with the next save, so the journal is never truncated past an unsaved file.
+    void RequestSave(std::vector<FileSnapshot> files);
+
+    // Queue bytes to append to the journal. Appends are written in order, after any pending save.
+    void RequestAppend(std::string entry);
+
+    // Queue bytes to append to any other file (e.g. an attempt history log). Unlike journal entries these are
+    // never dropped by a save; they are written in order, after any pending save.
+    void RequestAppendTo(const std::string& path, std::string bytes);
+
+    // Path of an older generation of `path` (generation 0 is the file itself).
+    static std::string GenerationPath(const std::string& path, int generation);
+
+    // Block until every queued save has hit the disk. Returns false if the last write failed.
+    bool Flush();
+
+    // Flush and join the writer thread. Further requests are ignored.
+    void Stop();
+
+    // Status lines produced on the writer thread; drained by the caller on its own thread.
+    std::vector<std::string> TakeMessages();
+
+    const std::string& GetJournalPath() const { return journal_path_; }
+    int GetWriteCount() const;
+
+    // Snapshot files written by the last batch, timed on the writer thread (serialization, write, sync and journal truncation).
+    struct SaveStats
+    {
+        uint64_t saves = 0;
+        double last_save_ms = 0.0;
+        size_t last_save_bytes = 0;
+    };
+    SaveStats GetSaveStats() const;
+
+private:
+    void Run();
+    bool HasPendingWork() const;
+    bool WriteAtomically(const std::string& path, const std::string& contents);
+    static bool SyncToDisk(std::FILE* file);
+    bool TruncateJournal();
+    bool AppendToJournal(const std::string& entries);
+    bool AppendToFile(const std::string& path, const std::string& bytes);
+    void PushMessage(std::string message);
+
+    std::string journal_path_;
+    int generations_ = 1;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::map<std::string, SnapshotFn> pending_files_;
+    bool pending_truncate_ = false;
+    std::string pending_appends_;
+    // Journal entries covered by the pending save: dropped if it succeeds, appended to the journal if it fails.
+    std::string superseded_appends_;
+    // Files whose last write failed, retried (unless replaced) with the next save.
+    std::map<std::string, SnapshotFn> failed_files_;
+    std::map<std::string, std::string> pending_file_appends_;
+    bool writing_ = false;
+    bool stopping_ = false;
+    bool last_write_ok_ = true;
+    int write_count_ = 0;
+    SaveStats save_stats_;
+    std::vector<std::string> messages_;
+
+    std::thread thread_;
+};
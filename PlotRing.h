@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Fixed-size history of float samples for the diagnostics plots. One thread pushes (the game thread, once per frame,
+// second or save); the settings window reads it on the render thread. Nothing is allocated after construction, and
+// slots not yet written read as 0.
+template <size_t N>
+class PlotRing
+{
+public:
+    void Push(float value)
+    {
+        const size_t next = next_.load(std::memory_order_relaxed);
+        values_[next % N].store(value, std::memory_order_relaxed);
+        next_.store(next + 1, std::memory_order_release);
+    }
+
+    // Index 0 is the oldest of the last N samples, N - 1 the newest.
+    float Get(size_t index) const
+    {
+        const size_t next = next_.load(std::memory_order_acquire);
+        return values_[(next + index) % N].load(std::memory_order_relaxed);
+    }
+
+    float Latest() const { return Get(N - 1); }
+
+    float Max() const
+    {
+        float max = 0.0f;
+        for (const auto& value : values_) {
+            const float v = value.load(std::memory_order_relaxed);
+            if (v > max) max = v;
+        }
+        return max;
+    }
+
+    static constexpr int Size() { return static_cast<int>(N); }
+
+    // Getter shapes expected by ImGui::PlotMultiLines and the multi-histogram ImGui::PlotHistogram (imguivariouscontrols).
+    static float LineGetter(const void* data, int index) { return static_cast<const PlotRing*>(data)->Get(static_cast<size_t>(index)); }
+    static float HistogramGetter(void* data, int index, int) { return static_cast<const PlotRing*>(data)->Get(static_cast<size_t>(index)); }
+
+private:
+    std::array<std::atomic<float>, N> values_{};
+    std::atomic<size_t> next_{ 0 };
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "ShotTable.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+// Boost is counted in whole input ticks spent holding boost, so sums and minimums are exact integers.
+// It is converted to boost units (0-100 tank) only for display and when written to or read from disk.
+using BoostTicks = uint32_t;
+// Boost drains at 33.3 units per second and SetVehicleInput runs at 120 Hz.
+constexpr double BOOST_AMOUNT_PER_TICK = 33.333333 / 120.0;
+// "No successful attempt yet" for the minimum-boost fields.
+constexpr BoostTicks NO_BOOST_TICKS = std::numeric_limits<BoostTicks>::max();
+
+inline double BoostTicksToAmount(BoostTicks ticks) { return ticks * BOOST_AMOUNT_PER_TICK; }
+
+// What the text and binary formats store: boost units, with FLT_MAX standing for NO_BOOST_TICKS as it always has.
+inline float BoostTicksToStoredAmount(BoostTicks ticks)
+{
+    return ticks == NO_BOOST_TICKS ? std::numeric_limits<float>::max() : static_cast<float>(BoostTicksToAmount(ticks));
+}
+
+// Rounds to the nearest tick. The stored FLT_MAX sentinel (or anything past the tick range) maps back to
+// NO_BOOST_TICKS; negative or NaN amounts can only come from a damaged file and read as 0.
+inline BoostTicks BoostAmountToTicks(double amount)
+{
+    if (!(amount > 0.0)) return 0;
+    if (amount >= BoostTicksToAmount(NO_BOOST_TICKS)) return NO_BOOST_TICKS;
+    return static_cast<BoostTicks>(amount / BOOST_AMOUNT_PER_TICK + 0.5);
+}
+
+// Per-session counters for a single shot. Mutated on every attempt and never persisted.
+struct ShotSessionStats
+{
+    int attempts = 0;
+    int successes = 0;
+    // Boost tracking variables (Current Session)
+    BoostTicks total_boost_ticks = 0;
+    BoostTicks total_successful_boost_ticks = 0;
+    BoostTicks min_successful_boost_ticks = NO_BOOST_TICKS;
+};
+
+// Persistent Lifetime Bests for a single shot (metrics tracked from the best consistency run).
+// Changes rarely; this is the only part of a shot's stats that is saved.
+struct ShotLifetimeStats
+{
+    int lifetime_best_successes = 0;
+    int lifetime_attempts_at_best = 0;
+    BoostTicks lifetime_total_boost_ticks_at_best = 0;
+    BoostTicks lifetime_total_successful_boost_ticks_at_best = 0;
+    BoostTicks lifetime_min_boost_ticks = NO_BOOST_TICKS; // Absolute lowest boost used on any successful shot
+
+    bool operator==(const ShotLifetimeStats&) const = default;
+};
+
+// This table holds all lifetime stats of a pack, keyed by Shot Index (int).
+using ShotPackStats = ShotTable<ShotLifetimeStats>;
+// This map holds all ShotPacks, keyed by the Training Pack Code (string).
+using PersistentData = std::map<std::string, ShotPackStats>;
+
+// Stats for the shots of the pack being played, kept as two blocks indexed by shot: the hot session counters,
+// owned here, and the cold lifetime bests, which are the pack's own entry in the global store (bound with Bind),
+// so lifetime updates land in place and nothing is copied back per attempt.
+// A shot is present once Ensure has been called for it.
+class SessionShotStats
+{
+public:
+    SessionShotStats() = default;
+    SessionShotStats(const SessionShotStats&) = delete;
+    SessionShotStats& operator=(const SessionShotStats&) = delete;
+
+    // Views `pack` (which must outlive the binding) with shots 0..shot_count-1 present and zeroed session counters.
+    // nullptr binds to an internal table that is never persisted (no pack ID available).
+    void Bind(ShotPackStats* pack, int shot_count)
+    {
+        clear();
+        if (pack) lifetime_ = pack;
+        if (shot_count <= 0) return;
+
+        lifetime_->reserve(static_cast<size_t>(shot_count));
+        session_.resize(static_cast<size_t>(shot_count));
+        lifetime_changed_.resize(session_.size(), 0);
+        for (int shot_index = 0; shot_index < shot_count; ++shot_index) {
+            (*lifetime_)[shot_index];
+        }
+    }
+
+    bool Contains(int shot_index) const { return shot_index >= 0 && static_cast<size_t>(shot_index) < session_.size(); }
+    bool empty() const { return session_.empty(); }
+    size_t size() const { return session_.size(); }
+
+    // Adds the shot (and a default lifetime entry in the bound pack, if it has none) when it is missing.
+    void Ensure(int shot_index)
+    {
+        (*lifetime_)[shot_index];
+        if (static_cast<size_t>(shot_index) >= session_.size()) {
+            session_.resize(static_cast<size_t>(shot_index) + 1);
+            lifetime_changed_.resize(session_.size(), 0);
+        }
+    }
+
+    // The shot must be present.
+    ShotSessionStats& Session(int shot_index) { return session_[shot_index]; }
+    const ShotSessionStats& Session(int shot_index) const { return session_[shot_index]; }
+    ShotLifetimeStats& Lifetime(int shot_index) { return (*lifetime_)[shot_index]; }
+    const ShotLifetimeStats& Lifetime(int shot_index) const { return lifetime_->at(shot_index); }
+
+    // Lifetime edits go straight into the pack, so callers flag them here until they are journaled/saved.
+    void MarkLifetimeChanged(int shot_index) { lifetime_changed_[shot_index] = 1; }
+    bool TakeLifetimeChanged(int shot_index)
+    {
+        if (!Contains(shot_index) || !lifetime_changed_[shot_index]) return false;
+        lifetime_changed_[shot_index] = 0;
+        return true;
+    }
+
+    // Zeroes every shot's session counters in one pass over the session block.
+    void ResetSession() { std::fill(session_.begin(), session_.end(), ShotSessionStats()); }
+    void ResetSession(int shot_index) { session_[shot_index] = ShotSessionStats(); }
+
+    // Drops the binding. Unjournaled lifetime changes must be taken first.
+    void clear()
+    {
+        session_.clear();
+        lifetime_changed_.clear();
+        detached_.clear();
+        lifetime_ = &detached_;
+    }
+
+private:
+    std::vector<ShotSessionStats> session_;
+    std::vector<uint8_t> lifetime_changed_;
+    ShotPackStats detached_;
+    ShotPackStats* lifetime_ = &detached_;
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Largest accepted shot index + 1, so a corrupt file cannot force a huge allocation.
+constexpr int MAX_SHOTS = 4096;
+inline bool IsValidShotIndex(int shot_index) { return shot_index >= 0 && shot_index < MAX_SHOTS; }
+
+// Per-shot values for one pack, stored contiguously and addressed directly by shot index (indices are dense,
+// 0..GetTotalRounds()-1). Keeps the std::map interface the plugin was written against: operator[] creates a
+// missing shot, and iteration visits only the shots that exist, in index order, as (index, value) pairs.
+template <typename T>
+class ShotTable
+{
+public:
+    using value_type = std::pair<int, T>; // `first` is the shot index; do not modify it through an iterator
+
+    template <typename Slot>
+    class BasicIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename ShotTable::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Slot*;
+        using reference = Slot&;
+
+        BasicIterator() = default;
+        BasicIterator(Slot* slot, Slot* end) : slot_(slot), end_(end) { SkipEmpty(); }
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+        BasicIterator& operator++() { ++slot_; SkipEmpty(); return *this; }
+        BasicIterator operator++(int) { BasicIterator old = *this; ++*this; return old; }
+        bool operator==(const BasicIterator& other) const { return slot_ == other.slot_; }
+        bool operator!=(const BasicIterator& other) const { return slot_ != other.slot_; }
+
+    private:
+        void SkipEmpty() { while (slot_ != end_ && slot_->first < 0) ++slot_; }
+
+        Slot* slot_ = nullptr;
+        Slot* end_ = nullptr;
+    };
+    using iterator = BasicIterator<value_type>;
+    using const_iterator = BasicIterator<const value_type>;
+
+    // Returns the shot's value, creating a default one (and growing the table) if the shot is not present.
+    // Throws std::out_of_range for an index outside 0..MAX_SHOTS-1.
+    T& operator[](int shot_index)
+    {
+        if (!IsValidShotIndex(shot_index)) throw std::out_of_range("shot index out of range");
+        if (static_cast<size_t>(shot_index) >= slots_.size()) {
+            slots_.resize(static_cast<size_t>(shot_index) + 1, value_type(EMPTY_SLOT, T()));
+        }
+        value_type& slot = slots_[shot_index];
+        if (slot.first == EMPTY_SLOT) {
+            slot.first = shot_index;
+            slot.second = T();
+            count_++;
+        }
+        return slot.second;
+    }
+
+    T& at(int shot_index)
+    {
+        if (!count(shot_index)) throw std::out_of_range("shot not present");
+        return slots_[shot_index].second;
+    }
+    const T& at(int shot_index) const
+    {
+        if (!count(shot_index)) throw std::out_of_range("shot not present");
+        return slots_[shot_index].second;
+    }
+
+    size_t count(int shot_index) const
+    {
+        return shot_index >= 0 && static_cast<size_t>(shot_index) < slots_.size() && slots_[shot_index].first != EMPTY_SLOT ? 1 : 0;
+    }
+
+    iterator find(int shot_index) { return count(shot_index) ? iterator(&slots_[shot_index], EndSlot()) : end(); }
+    const_iterator find(int shot_index) const { return count(shot_index) ? const_iterator(&slots_[shot_index], EndSlot()) : end(); }
+
+    size_t erase(int shot_index)
+    {
+        if (!count(shot_index)) return 0;
+        slots_[shot_index].first = EMPTY_SLOT;
+        count_--;
+        return 1;
+    }
+
+    // Number of shots present (not the highest index).
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    // Keeps the allocation, since the next pack usually has a similar number of shots.
+    void clear() { slots_.clear(); count_ = 0; }
+    void reserve(size_t shots) { slots_.reserve(shots); }
+
+    iterator begin() { return iterator(slots_.data(), EndSlot()); }
+    iterator end() { return iterator(EndSlot(), EndSlot()); }
+    const_iterator begin() const { return const_iterator(slots_.data(), EndSlot()); }
+    const_iterator end() const { return const_iterator(EndSlot(), EndSlot()); }
+
+private:
+    static constexpr int EMPTY_SLOT = -1;
+
+    value_type* EndSlot() { return slots_.data() + slots_.size(); }
+    const value_type* EndSlot() const { return slots_.data() + slots_.size(); }
+
+    std::vector<value_type> slots_;
+    size_t count_ = 0;
+};
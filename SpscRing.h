@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded single-producer/single-consumer queue. TryPush and TryPop never block or allocate; a push into a full
+// ring is dropped and counted instead. Exactly one thread may push and one (possibly the same) may pop.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool TryPush(const T& item)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T& out)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = slots_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pops until empty, in push order; returns how many items were handed to `fn`.
+    template <typename Fn>
+    size_t Drain(Fn&& fn)
+    {
+        size_t count = 0;
+        T item;
+        while (TryPop(item)) {
+            fn(item);
+            count++;
+        }
+        return count;
+    }
+
+    // Exact from the consumer thread, a snapshot from anywhere else.
+    size_t size() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+    static constexpr size_t capacity() { return Capacity; }
+    uint64_t DroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // Producer and consumer indices on separate cache lines so the two sides do not false-share.
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    alignas(64) std::atomic<uint64_t> dropped_{ 0 };
+    std::array<T, Capacity> slots_{};
+};
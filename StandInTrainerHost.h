@@ -0,0 +1,52 @@
+#pragma once
+
+#include "TrainerHost.h"
+#include "StatsTextFormat.h"
+#include "logging.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// TrainerHost without the game, for building and profiling TrainerCore on Linux (or anywhere without the SDK).
+// A driver plays the game's part by calling the core's event methods (passing its own boost total); this side
+// records what the plugin would have done.
+class StandInTrainerHost : public TrainerHost
+{
+public:
+    // Journal records are encoded in the plugin's text format, for the pack with this ID.
+    explicit StandInTrainerHost(std::string pack_id = "STANDIN") : pack_id_(std::move(pack_id)) {}
+
+    void OnAttemptStateChanged() override { state_changes++; }
+    void RepeatCurrentShot() override { shots_repeated++; }
+    void RecordAttempt(const AttemptHistory::AttemptRecord& record) override { attempts.push_back(record); }
+    // Appends every commit to the journal; the plugin only journals shots whose lifetime block changed.
+    void CommitLifetime(int shot_index, const ShotLifetimeStats& lifetime) override { AppendStatsRecord(journal, pack_id_, shot_index, lifetime); }
+
+    void Clear()
+    {
+        attempts.clear();
+        journal.clear();
+        state_changes = 0;
+        shots_repeated = 0;
+    }
+
+    std::vector<AttemptHistory::AttemptRecord> attempts;
+    std::string journal;
+    uint64_t state_changes = 0;
+    uint64_t shots_repeated = 0;
+
+private:
+    std::string pack_id_;
+};
+
+// The stand-in for the plugin's console: writes the queued LOG lines to `out` (nullptr discards them).
+inline size_t DrainLogTo(FILE* out)
+{
+    return DrainLog([out](LogLevel, std::string_view text) {
+        if (!out) return;
+        std::fwrite(text.data(), 1, text.size(), out);
+        std::fputc('\n', out);
+    });
+}
@@ -0,0 +1,203 @@
+#include "StatsBinaryFormat.h"
+#include "Crc32c.h"
+
+#include <cstring>
+
+namespace
+{
+    // Fields are copied through memcpy so reads from the mapped view never depend on alignment.
+    template <typename T>
+    void Put(std::string& out, T value)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+
+    template <typename T>
+    char* PutAt(char* out, T value)
+    {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    void PutHeader(std::string& out, uint32_t pack_count, uint32_t record_count, uint32_t string_bytes)
+    {
+        out.append(StatsBinary::MAGIC, sizeof(StatsBinary::MAGIC));
+        Put<uint16_t>(out, StatsBinary::VERSION);
+        Put<uint16_t>(out, static_cast<uint16_t>(StatsBinary::HEADER_SIZE));
+        Put<uint32_t>(out, pack_count);
+        Put<uint32_t>(out, record_count);
+        Put<uint32_t>(out, string_bytes);
+        Put<uint32_t>(out, 0); // Checksum, filled in by SealChecksum once the body is written
+    }
+
+    void SealChecksum(std::string& out)
+    {
+        uint32_t crc = Crc32c(out.data() + StatsBinary::HEADER_SIZE, out.size() - StatsBinary::HEADER_SIZE);
+        std::memcpy(out.data() + StatsBinary::HEADER_SIZE - sizeof(uint32_t), &crc, sizeof(crc));
+    }
+
+    void PutPackEntry(std::string& out, uint32_t name_offset, uint32_t name_length, uint32_t first_record, uint32_t record_count)
+    {
+        Put<uint32_t>(out, name_offset);
+        Put<uint32_t>(out, name_length);
+        Put<uint32_t>(out, first_record);
+        Put<uint32_t>(out, record_count);
+    }
+
+    template <typename T>
+    T Get(const uint8_t* p)
+    {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    }
+}
+
+namespace StatsBinary
+{
+    bool HasMagic(const uint8_t* data, size_t size)
+    {
+        return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    void EncodeRecord(EncodedRecord& out, int shot_index, const ShotLifetimeStats& s)
+    {
+        char* p = out.data();
+        p = PutAt<int32_t>(p, shot_index);
+        p = PutAt<int32_t>(p, s.lifetime_best_successes);
+        p = PutAt<int32_t>(p, s.lifetime_attempts_at_best);
+        // Boost stays in boost units on disk, so the layout is unchanged by the in-memory tick counts.
+        p = PutAt<float>(p, BoostTicksToStoredAmount(s.lifetime_total_boost_ticks_at_best));
+        p = PutAt<float>(p, BoostTicksToStoredAmount(s.lifetime_total_successful_boost_ticks_at_best));
+        PutAt<float>(p, BoostTicksToStoredAmount(s.lifetime_min_boost_ticks));
+    }
+
+    std::string Encode(const PersistentData& data)
+    {
+        uint32_t record_count = 0;
+        uint32_t string_bytes = 0;
+        for (const auto& pack_pair : data) {
+            record_count += static_cast<uint32_t>(pack_pair.second.size());
+            string_bytes += static_cast<uint32_t>(pack_pair.first.size());
+        }
+
+        std::string out;
+        out.reserve(HEADER_SIZE + data.size() * PACK_ENTRY_SIZE + record_count * RECORD_SIZE + string_bytes);
+        PutHeader(out, static_cast<uint32_t>(data.size()), record_count, string_bytes);
+
+        uint32_t name_offset = 0;
+        uint32_t first_record = 0;
+        for (const auto& pack_pair : data) {
+            PutPackEntry(out, name_offset, static_cast<uint32_t>(pack_pair.first.size()), first_record, static_cast<uint32_t>(pack_pair.second.size()));
+            name_offset += static_cast<uint32_t>(pack_pair.first.size());
+            first_record += static_cast<uint32_t>(pack_pair.second.size());
+        }
+
+        EncodedRecord record;
+        for (const auto& pack_pair : data) {
+            for (const auto& shot_pair : pack_pair.second) {
+                EncodeRecord(record, shot_pair.first, shot_pair.second);
+                out.append(record.data(), RECORD_SIZE);
+            }
+        }
+
+        for (const auto& pack_pair : data) {
+            out += pack_pair.first;
+        }
+        SealChecksum(out);
+        return out;
+    }
+
+    std::string EncodePack(const std::string& pack_id, const std::vector<EncodedRecord>& records)
+    {
+        const uint32_t record_count = static_cast<uint32_t>(records.size());
+        const uint32_t name_length = static_cast<uint32_t>(pack_id.size());
+
+        std::string out;
+        out.reserve(HEADER_SIZE + PACK_ENTRY_SIZE + records.size() * RECORD_SIZE + pack_id.size());
+        PutHeader(out, 1, record_count, name_length);
+        PutPackEntry(out, 0, name_length, 0, record_count);
+        for (const EncodedRecord& record : records) {
+            out.append(record.data(), RECORD_SIZE);
+        }
+        out += pack_id;
+        SealChecksum(out);
+        return out;
+    }
+
+    bool Decode(const uint8_t* data, size_t size, PersistentData& out, std::string& error)
+    {
+        out.clear();
+
+        if (size < HEADER_SIZE_V1 || !HasMagic(data, size)) {
+            error = "missing binary header";
+            return false;
+        }
+
+        uint16_t version = Get<uint16_t>(data + 4);
+        uint16_t header_size = Get<uint16_t>(data + 6);
+        uint32_t pack_count = Get<uint32_t>(data + 8);
+        uint32_t record_count = Get<uint32_t>(data + 12);
+        uint32_t string_bytes = Get<uint32_t>(data + 16);
+
+        const size_t expected_header = version == 1 ? HEADER_SIZE_V1 : HEADER_SIZE;
+        if (version < 1 || version > VERSION || header_size < expected_header || header_size > size) {
+            error = "unsupported binary version " + std::to_string(version);
+            return false;
+        }
+
+        const uint64_t directory_offset = header_size;
+        const uint64_t records_offset = directory_offset + uint64_t(pack_count) * PACK_ENTRY_SIZE;
+        const uint64_t strings_offset = records_offset + uint64_t(record_count) * RECORD_SIZE;
+        if (strings_offset + string_bytes > size) {
+            error = "file is shorter than its header claims";
+            return false;
+        }
+
+        if (version >= 2) {
+            uint32_t stored_crc = Get<uint32_t>(data + 20);
+            if (strings_offset + string_bytes != size || Crc32c(data + header_size, size - header_size) != stored_crc) {
+                error = "checksum mismatch";
+                return false;
+            }
+        }
+
+        const char* strings = reinterpret_cast<const char*>(data + strings_offset);
+
+        for (uint32_t p = 0; p < pack_count; ++p) {
+            const uint8_t* entry = data + directory_offset + uint64_t(p) * PACK_ENTRY_SIZE;
+            uint32_t name_offset = Get<uint32_t>(entry);
+            uint32_t name_length = Get<uint32_t>(entry + 4);
+            uint32_t first_record = Get<uint32_t>(entry + 8);
+            uint32_t pack_records = Get<uint32_t>(entry + 12);
+
+            if (uint64_t(name_offset) + name_length > string_bytes ||
+                uint64_t(first_record) + pack_records > record_count) {
+                error = "pack directory entry " + std::to_string(p) + " is out of range";
+                out.clear();
+                return false;
+            }
+
+            ShotPackStats& pack = out[std::string(strings + name_offset, name_length)];
+
+            const uint8_t* record = data + records_offset + uint64_t(first_record) * RECORD_SIZE;
+            for (uint32_t r = 0; r < pack_records; ++r, record += RECORD_SIZE) {
+                const int32_t shot_index = Get<int32_t>(record);
+                if (!IsValidShotIndex(shot_index)) {
+                    error = "shot index " + std::to_string(shot_index) + " is out of range";
+                    out.clear();
+                    return false;
+                }
+                ShotLifetimeStats& s = pack[shot_index];
+                s.lifetime_best_successes = Get<int32_t>(record + 4);
+                s.lifetime_attempts_at_best = Get<int32_t>(record + 8);
+                s.lifetime_total_boost_ticks_at_best = BoostAmountToTicks(Get<float>(record + 12));
+                s.lifetime_total_successful_boost_ticks_at_best = BoostAmountToTicks(Get<float>(record + 16));
+                s.lifetime_min_boost_ticks = BoostAmountToTicks(Get<float>(record + 20));
+            }
+        }
+        return true;
+    }
+}
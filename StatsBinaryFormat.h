@@ -0,0 +1,47 @@
+#pragma once
+
+// Compact binary snapshot of PersistentData (lifetime fields only).
+//
+// Layout (little-endian, no padding):
+//   Header         magic "CTSB", u16 version, u16 header size, u32 pack count, u32 record count, u32 string bytes,
+//                  u32 CRC-32C of everything after the header (version 2+)
+//   Pack directory pack count x { u32 name offset, u32 name length, u32 first record, u32 record count }
+//   Records        record count x { i32 shot index, i32 LBS, i32 LBA, f32 LBTB, f32 LBTSB, f32 LMB }
+//   String table   pack names, concatenated
+// Boost fields are in boost units (BoostTicksToStoredAmount); they are rounded back to ticks on decode.
+
+#include "ShotStats.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace StatsBinary
+{
+    constexpr char MAGIC[4] = { 'C', 'T', 'S', 'B' };
+    constexpr uint16_t VERSION = 2;
+
+    constexpr size_t HEADER_SIZE = 24;
+    constexpr size_t HEADER_SIZE_V1 = 20; // Version 1 had no checksum; still readable
+    constexpr size_t PACK_ENTRY_SIZE = 16;
+    constexpr size_t RECORD_SIZE = 24;
+
+    // True if the buffer starts with the binary magic (used to tell it apart from the text format).
+    bool HasMagic(const uint8_t* data, size_t size);
+
+    // One record's bytes, so callers can cache encodings and only redo the shots that changed.
+    using EncodedRecord = std::array<char, RECORD_SIZE>;
+
+    void EncodeRecord(EncodedRecord& out, int shot_index, const ShotLifetimeStats& s);
+
+    std::string Encode(const PersistentData& data);
+
+    // Builds a single-pack file from records that are already encoded and ordered by shot index.
+    std::string EncodePack(const std::string& pack_id, const std::vector<EncodedRecord>& records);
+
+    // Fills `out` from an encoded buffer. Returns false and sets `error` if the buffer is truncated, inconsistent,
+    // or (version 2+) fails its checksum, so a torn or corrupted write is never half-loaded.
+    bool Decode(const uint8_t* data, size_t size, PersistentData& out, std::string& error);
+}
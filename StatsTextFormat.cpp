@@ -0,0 +1,239 @@
+#include "StatsTextFormat.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Upper bounds for one formatted field: "-2147483648" and the longest shortest-form float ("-1.17549435e-38").
+    constexpr size_t MAX_INT_CHARS = 11;
+    constexpr size_t MAX_FLOAT_CHARS = 15;
+    constexpr size_t MAX_RECORD_OVERHEAD = 3 * MAX_INT_CHARS + 3 * MAX_FLOAT_CHARS + 7; // 6 '|' + ';'
+
+    template <typename T>
+    char* WriteField(char* first, char* last, T value) {
+        // Floats use the shortest representation that parses back to the same value.
+        return std::to_chars(first, last, value).ptr;
+    }
+
+    // Writes one record plus its ';' terminator into [first, last), which must hold MaxRecordSize bytes.
+    char* WriteRecord(char* first, char* last, std::string_view pack_id, int shot_index, const ShotLifetimeStats& s) {
+        first = std::copy(pack_id.begin(), pack_id.end(), first);
+        *first++ = '|';
+        first = WriteField(first, last, shot_index);
+        *first++ = '|';
+        first = WriteField(first, last, s.lifetime_best_successes);
+        *first++ = '|';
+        first = WriteField(first, last, s.lifetime_attempts_at_best);
+        *first++ = '|';
+        first = WriteField(first, last, BoostTicksToStoredAmount(s.lifetime_total_boost_ticks_at_best));
+        *first++ = '|';
+        first = WriteField(first, last, BoostTicksToStoredAmount(s.lifetime_total_successful_boost_ticks_at_best));
+        *first++ = '|';
+        first = WriteField(first, last, BoostTicksToStoredAmount(s.lifetime_min_boost_ticks));
+        *first++ = ';';
+        return first;
+    }
+
+    size_t MaxRecordSize(std::string_view pack_id) {
+        return pack_id.size() + MAX_RECORD_OVERHEAD;
+    }
+
+    bool WriteAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+#ifdef _WIN32
+            int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+            ssize_t written = ::write(fd, data, size);
+#endif
+            if (written <= 0) return false;
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+}
+
+void AppendStatsRecord(std::string& out, std::string_view pack_id, int shot_index, const ShotLifetimeStats& s) {
+    size_t old_size = out.size();
+    out.resize(old_size + MaxRecordSize(pack_id));
+    char* end = WriteRecord(out.data() + old_size, out.data() + out.size(), pack_id, shot_index, s);
+    out.resize(end - out.data());
+}
+
+std::string SerializeStatsRecord(const std::string& pack_id, int shot_index, const ShotLifetimeStats& s) {
+    std::string out;
+    AppendStatsRecord(out, pack_id, shot_index, s);
+    out.pop_back();
+    return out;
+}
+
+std::string SerializeStats(const PersistentData& data) {
+    size_t capacity = 0;
+    for (const auto& pack_pair : data) {
+        capacity += pack_pair.second.size() * MaxRecordSize(pack_pair.first);
+    }
+
+    std::string out;
+    out.resize(capacity);
+    char* cursor = out.data();
+    char* last = out.data() + out.size();
+    for (const auto& pack_pair : data) {
+        for (const auto& shot_pair : pack_pair.second) {
+            cursor = WriteRecord(cursor, last, pack_pair.first, shot_pair.first, shot_pair.second);
+        }
+    }
+    out.resize(cursor - out.data());
+
+    if (!out.empty()) {
+        out.pop_back();
+    }
+    return out;
+}
+
+bool WriteStats(int fd, const PersistentData& data) {
+    // Records are formatted into one reserved chunk that is flushed whenever it fills up.
+    constexpr size_t CHUNK_SIZE = 64 * 1024;
+    std::string chunk;
+    chunk.reserve(CHUNK_SIZE);
+
+    for (const auto& pack_pair : data) {
+        for (const auto& shot_pair : pack_pair.second) {
+            if (!chunk.empty() && chunk.size() + MaxRecordSize(pack_pair.first) > chunk.capacity()) {
+                // Keep the last ';' back: it only belongs in the output if another record follows.
+                if (!WriteAll(fd, chunk.data(), chunk.size() - 1)) return false;
+                chunk.assign(1, ';');
+            }
+            AppendStatsRecord(chunk, pack_pair.first, shot_pair.first, shot_pair.second);
+        }
+    }
+
+    if (chunk.empty()) return true;
+    return WriteAll(fd, chunk.data(), chunk.size() - 1);
+}
+
+namespace
+{
+    constexpr size_t MAX_SEGMENTS = 7;
+
+    // The whole segment must be consumed; "12abc" or "" is rejected instead of silently truncated.
+    template <typename T>
+    bool ParseField(std::string_view segment, T& out) {
+        const char* first = segment.data();
+        const char* last = first + segment.size();
+        auto [ptr, ec] = std::from_chars(first, last, out);
+        return ec == std::errc() && ptr == last && first != last;
+    }
+
+    void ReportMalformed(StatsParseReport* report, int record_index, const char* reason) {
+        if (!report) return;
+        report->malformed_records++;
+        if (report->first_error.empty()) {
+            report->first_error = "record " + std::to_string(record_index) + ": " + reason;
+        }
+    }
+}
+
+PersistentData DeserializeStats(std::string_view str, StatsParseReport* report) {
+    PersistentData data;
+
+    // Records are written grouped by pack, so remembering the last pack avoids a string lookup
+    // (and a std::string allocation for the key) on every record.
+    ShotPackStats* current_pack = nullptr;
+    std::string_view current_pack_id;
+
+    int record_index = 0;
+    size_t pos = 0;
+    while (pos <= str.size()) {
+        size_t record_end = str.find(';', pos);
+        if (record_end == std::string_view::npos) record_end = str.size();
+        std::string_view record = str.substr(pos, record_end - pos);
+        pos = record_end + 1;
+
+        if (record.empty()) continue;
+        record_index++;
+
+        std::array<std::string_view, MAX_SEGMENTS> segments;
+        size_t segment_count = 0;
+        bool too_many_segments = false;
+        size_t seg_pos = 0;
+        while (seg_pos <= record.size()) {
+            size_t seg_end = record.find('|', seg_pos);
+            if (seg_end == std::string_view::npos) seg_end = record.size();
+            if (segment_count == MAX_SEGMENTS) {
+                too_many_segments = true;
+                break;
+            }
+            segments[segment_count++] = record.substr(seg_pos, seg_end - seg_pos);
+            seg_pos = seg_end + 1;
+        }
+
+        if (too_many_segments || segment_count < 6) {
+            ReportMalformed(report, record_index, "unexpected segment count");
+            continue;
+        }
+
+        const bool legacy = segment_count == 6;
+        // Legacy records have no LBA segment, so the boost fields start one segment earlier.
+        const size_t boost_segment = legacy ? 3 : 4;
+
+        int shot_index = 0;
+        ShotLifetimeStats s;
+        float total_boost = 0.0f;
+        float total_successful_boost = 0.0f;
+        float min_boost = 0.0f;
+        bool ok = ParseField(segments[1], shot_index)
+            && ParseField(segments[2], s.lifetime_best_successes)
+            && (legacy || ParseField(segments[3], s.lifetime_attempts_at_best))
+            && ParseField(segments[boost_segment], total_boost)
+            && ParseField(segments[boost_segment + 1], total_successful_boost)
+            && ParseField(segments[boost_segment + 2], min_boost);
+
+        if (!ok) {
+            ReportMalformed(report, record_index, "field is not a number");
+            continue;
+        }
+
+        if (!IsValidShotIndex(shot_index)) {
+            ReportMalformed(report, record_index, "shot index out of range");
+            continue;
+        }
+
+        if (legacy) {
+            s.lifetime_attempts_at_best = 10;
+        }
+        s.lifetime_total_boost_ticks_at_best = BoostAmountToTicks(total_boost);
+        s.lifetime_total_successful_boost_ticks_at_best = BoostAmountToTicks(total_successful_boost);
+        s.lifetime_min_boost_ticks = BoostAmountToTicks(min_boost);
+
+        if (!current_pack || segments[0] != current_pack_id) {
+            current_pack = &data[std::string(segments[0])];
+            current_pack_id = segments[0];
+        }
+        (*current_pack)[shot_index] = s;
+
+        if (report) {
+            report->records++;
+            if (legacy) report->legacy_records++;
+        }
+    }
+    return data;
+}
+
+PersistentData DeserializeJournal(std::string_view journal, StatsParseReport* report) {
+    const size_t last_terminator = journal.rfind(';');
+    if (last_terminator == std::string_view::npos) {
+        if (report) *report = StatsParseReport();
+        return PersistentData();
+    }
+    return DeserializeStats(journal.substr(0, last_terminator), report);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Text record format used by the journal and by the legacy ConsistencyTrainer.data file.
+//   PackID|ShotIndex|LBS|LBA|LBTB|LBTSB|LMB;...   (7 segments)
+//   PackID|ShotIndex|LBS|LBTB|LBTSB|LMB;...       (legacy 6 segments, LBA assumed to be 10)
+
+#include "ShotStats.h"
+
+#include <string>
+#include <string_view>
+
+// Outcome of a DeserializeStats call. Malformed records are skipped, never thrown.
+struct StatsParseReport
+{
+    int records = 0;           // Records accepted (including legacy ones)
+    int legacy_records = 0;    // 6-segment records
+    int malformed_records = 0; // Records skipped because a field was missing or not a number
+    std::string first_error;   // Description of the first malformed record, empty if none
+};
+
+// Numbers are written with std::to_chars (locale-independent, floats in shortest round-trip form).
+// Boost fields are written in boost units and rounded to whole ticks when read, so
+// SerializeStats(DeserializeStats(x)) reproduces x byte for byte whenever x was written by SerializeStats.
+
+// Appends one record including its trailing ';'.
+void AppendStatsRecord(std::string& out, std::string_view pack_id, int shot_index, const ShotLifetimeStats& s);
+// One PackID|ShotIndex|LBS|LBA|LBTB|LBTSB|LMB record, without the trailing ';'.
+std::string SerializeStatsRecord(const std::string& pack_id, int shot_index, const ShotLifetimeStats& s);
+// Whole data set in one buffer, sized up front from the pack names and record counts.
+std::string SerializeStats(const PersistentData& data);
+// Same output as SerializeStats, streamed to a file descriptor through a fixed 64 KiB buffer.
+bool WriteStats(int fd, const PersistentData& data);
+
+// Single pass over the input; fields are parsed in place with std::from_chars.
+// Later records for the same pack/shot overwrite earlier ones, which is what journal replay relies on.
+PersistentData DeserializeStats(std::string_view str, StatsParseReport* report = nullptr);
+// Journal replay: every journal entry is appended with its trailing ';', so anything after the last ';' is an entry
+// torn by a crash mid-append and is ignored.
+PersistentData DeserializeJournal(std::string_view journal, StatsParseReport* report = nullptr);
@@ -0,0 +1,225 @@
+#include "TrainerCore.h"
+#include "logging.h"
+
+#include <algorithm>
+
+void TrainerCore::BindPack(ShotPackStats* pack, int shot_count, int shot_index) {
+    // Damaged boost values are already clamped when the shard is decoded (BoostAmountToTicks).
+    session_stats_.Bind(pack, std::min(shot_count, MAX_SHOTS));
+    current_shot_index_ = shot_index;
+}
+
+void TrainerCore::ClearSession() {
+    session_stats_.clear();
+    current_shot_index_ = 0;
+    attempt_state_ = AttemptState::Idle;
+    expected_self_resets_ = 0;
+}
+
+void TrainerCore::ResetSession() {
+    session_stats_.ResetSession();
+    attempt_state_ = AttemptState::Idle;
+    expected_self_resets_ = 0;
+    host_.OnAttemptStateChanged();
+}
+
+void TrainerCore::ResetCurrentShotSessionStats(ShotSessionStats& stats) {
+    stats = ShotSessionStats();
+}
+
+bool TrainerCore::UpdateLifetimeBest(int shot_index, const ShotSessionStats& stats, ShotLifetimeStats& lifetime) {
+    const ShotLifetimeStats before = lifetime;
+
+    if (stats.min_successful_boost_ticks < lifetime.lifetime_min_boost_ticks)
+    {
+        lifetime.lifetime_min_boost_ticks = stats.min_successful_boost_ticks;
+        LOG("New Lifetime Best Min Boost (Individual) for Shot {}: {:.1f}", shot_index + 1, BoostTicksToAmount(lifetime.lifetime_min_boost_ticks));
+    }
+
+    if (stats.attempts > 0) {
+
+        bool attempts_increased = (stats.attempts > lifetime.lifetime_attempts_at_best);
+        bool success_improved = (stats.successes > lifetime.lifetime_best_successes);
+
+        if (attempts_increased) {
+            lifetime.lifetime_attempts_at_best = stats.attempts;
+            lifetime.lifetime_best_successes = stats.successes;
+
+            lifetime.lifetime_total_boost_ticks_at_best = stats.total_boost_ticks;
+            lifetime.lifetime_total_successful_boost_ticks_at_best = stats.total_successful_boost_ticks;
+            LOG("New Lifetime Best Run Length (Attempts/Success) for Shot {}: {}/{}", shot_index + 1, stats.attempts, stats.successes);
+        }
+
+        if (success_improved) {
+            if (stats.successes > lifetime.lifetime_best_successes) {
+                lifetime.lifetime_best_successes = stats.successes;
+                lifetime.lifetime_attempts_at_best = stats.attempts;
+                lifetime.lifetime_total_boost_ticks_at_best = stats.total_boost_ticks;
+                lifetime.lifetime_total_successful_boost_ticks_at_best = stats.total_successful_boost_ticks;
+                LOG("New Absolute Best Success Count for Shot {}: {}/{}", shot_index + 1, stats.successes, stats.attempts);
+            }
+        }
+        else if (stats.successes == lifetime.lifetime_best_successes)
+        {
+            if (stats.attempts >= lifetime.lifetime_attempts_at_best) {
+
+                if (stats.total_boost_ticks < lifetime.lifetime_total_boost_ticks_at_best) {
+                    lifetime.lifetime_attempts_at_best = stats.attempts;
+                    lifetime.lifetime_total_boost_ticks_at_best = stats.total_boost_ticks;
+                    lifetime.lifetime_total_successful_boost_ticks_at_best = stats.total_successful_boost_ticks;
+                    LOG("Boost Tie-breaker Update for Shot {}. Same success count, but less total boost used.", shot_index + 1);
+                }
+            }
+        }
+    }
+    return lifetime != before;
+}
+
+bool TrainerCore::IsShotFrozen() const
+{
+    if (!session_stats_.Contains(current_shot_index_)) return true;
+
+    return session_stats_.Session(current_shot_index_).attempts >= max_attempts_per_shot_;
+}
+
+void TrainerCore::OnShotAttempt(Clock::time_point time, BoostTicks boost_total)
+{
+    if (!IsValidShotIndex(current_shot_index_)) return;
+
+    session_stats_.Ensure(current_shot_index_);
+    ShotSessionStats& stats = session_stats_.Session(current_shot_index_);
+    ShotLifetimeStats& lifetime = session_stats_.Lifetime(current_shot_index_);
+
+    if (stats.attempts < max_attempts_per_shot_) {
+
+        if (stats.attempts + 1 > lifetime.lifetime_attempts_at_best) {
+            lifetime.lifetime_attempts_at_best = stats.attempts + 1;
+            session_stats_.MarkLifetimeChanged(current_shot_index_);
+
+            LOG("New Lifetime Best Run Length (Attempts) set to: {} upon shot start.", lifetime.lifetime_attempts_at_best);
+        }
+
+        stats.attempts++;
+        LOG("Shot attempt {} started (Immediate Increment). Boost counter reset to 0.0.", stats.attempts);
+    }
+    else if (stats.attempts >= max_attempts_per_shot_) {
+        ResetCurrentShotSessionStats(stats);
+        stats.attempts = 1;
+        LOG("Max attempts exceeded/Stuck counter. Forced Reset. Starting Attempt 1 of new run.");
+    }
+
+    if (attempt_state_ == AttemptState::Settled) {
+        last_outcome_to_attempt_ = time - settled_time_;
+        max_outcome_to_attempt_ = std::max(max_outcome_to_attempt_, last_outcome_to_attempt_);
+    }
+    attempt_state_ = AttemptState::Live;
+
+    attempt_boost_start_ = boost_total;
+    attempt_start_time_ = time;
+    host_.OnAttemptStateChanged();
+}
+
+void TrainerCore::OnOutcome(bool success, Clock::time_point time, BoostTicks boost_total)
+{
+    // Only the first outcome of a live attempt counts: a goal is followed by the ball exploding and the shot
+    // resetting, and those must not be recorded as further (failed) attempts.
+    if (attempt_state_ != AttemptState::Live) {
+        duplicate_outcomes_++;
+        return;
+    }
+
+    attempt_state_ = AttemptState::Settled;
+    settled_time_ = time;
+    HandleAttempt(success, time, boost_total - attempt_boost_start_);
+}
+
+void TrainerCore::OnShotReset(Clock::time_point time, BoostTicks boost_total)
+{
+    if (expected_self_resets_ > 0) {
+        expected_self_resets_--;
+        self_resets_++;
+        return;
+    }
+    OnOutcome(false, time, boost_total);
+}
+
+void TrainerCore::OnShotChanged(int index, int shot_count)
+{
+    int new_index = index;
+
+    if (shot_count > 0 && new_index >= shot_count) {
+        new_index = 0;
+        LOG("Playlist index looped FORWARD. Corrected index from {} to {}", index, new_index);
+    }
+    else if (shot_count > 0 && new_index < 0) {
+        new_index = shot_count - 1;
+        LOG("Playlist index looped BACKWARD. Corrected index from {} to {}", index, new_index);
+    }
+
+
+    if (current_shot_index_ != new_index && session_stats_.Contains(current_shot_index_)) {
+        ShotLifetimeStats& previous_lifetime = session_stats_.Lifetime(current_shot_index_);
+        if (UpdateLifetimeBest(current_shot_index_, session_stats_.Session(current_shot_index_), previous_lifetime)) {
+            session_stats_.MarkLifetimeChanged(current_shot_index_);
+        }
+
+        host_.CommitLifetime(current_shot_index_, previous_lifetime);
+    }
+
+    if (current_shot_index_ != new_index) {
+        current_shot_index_ = new_index;
+        LOG("Playlist index changed to: {}", current_shot_index_);
+    }
+    // An attempt on the previous shot is abandoned without an outcome. A reset still owed by RepeatCurrentShot
+    // would land on the new shot, where it is no longer ours to absorb: the Idle state drops it anyway.
+    attempt_state_ = AttemptState::Idle;
+    expected_self_resets_ = 0;
+    host_.OnAttemptStateChanged();
+}
+
+void TrainerCore::HandleAttempt(bool success, Clock::time_point time, BoostTicks boost_ticks)
+{
+    if (!session_stats_.Contains(current_shot_index_)) {
+        return;
+    }
+
+    ShotSessionStats& stats = session_stats_.Session(current_shot_index_);
+    ShotLifetimeStats& lifetime = session_stats_.Lifetime(current_shot_index_);
+
+    bool is_final_attempt = stats.attempts == max_attempts_per_shot_;
+
+    stats.total_boost_ticks += boost_ticks;
+
+    if (success) {
+        stats.successes++;
+        stats.total_successful_boost_ticks += boost_ticks;
+        stats.min_successful_boost_ticks = std::min(stats.min_successful_boost_ticks, boost_ticks);
+        LOG("SUCCESS recorded. Attempt {}. Boost Used: {:.1f}", stats.attempts, BoostTicksToAmount(boost_ticks));
+    }
+    else {
+        LOG("FAILURE recorded. Attempt {}. Boost Used: {:.1f}", stats.attempts, BoostTicksToAmount(boost_ticks));
+    }
+
+    AttemptHistory::AttemptRecord record;
+    record.shot_index = current_shot_index_;
+    record.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    record.success = success;
+    record.boost_used = static_cast<float>(BoostTicksToAmount(boost_ticks));
+    record.duration_ms = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(time - attempt_start_time_).count());
+    host_.RecordAttempt(record);
+
+    if (UpdateLifetimeBest(current_shot_index_, stats, lifetime)) {
+        session_stats_.MarkLifetimeChanged(current_shot_index_);
+    }
+
+    host_.CommitLifetime(current_shot_index_, lifetime);
+
+    if (is_final_attempt) {
+        ResetCurrentShotSessionStats(stats);
+        LOG("Shot {} completed max attempts. Session stats reset and shot repeated (new run started).", current_shot_index_ + 1);
+    }
+    // Set before the call: the game may fire the reset from inside it.
+    expected_self_resets_ = 1;
+    host_.RepeatCurrentShot();
+    host_.OnAttemptStateChanged();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ShotStats.h"
+#include "TrainerHost.h"
+
+#include <chrono>
+#include <cstdint>
+
+// The attempt state machine and per-shot stats, with no SDK dependency: the plugin feeds it game events already
+// filtered for "enabled and in training", and it reaches back into the game only through TrainerHost.
+//
+// Boost is measured by the host as a running total that only grows (ticks spent boosting, plus what a boost meter
+// saw). Attempt start and outcome events carry that total as read when the game fired them, and an attempt is
+// charged the difference, so boost used while an event waits to be applied lands in the right attempt.
+class TrainerCore
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Attempt lifecycle, driven by event order alone: Live from TrainingShotAttempt until its first outcome, then
+    // Settled until the next attempt starts. Idle after a session start, shot change or session reset.
+    enum class AttemptState : uint8_t { Idle, Live, Settled };
+
+    explicit TrainerCore(TrainerHost& host) : host_(host) {}
+    TrainerCore(const TrainerCore&) = delete;
+    TrainerCore& operator=(const TrainerCore&) = delete;
+
+    // Views `pack` (nullptr: an unsaved table) with shots 0..shot_count-1 and starts on `shot_index`.
+    void BindPack(ShotPackStats* pack, int shot_count, int shot_index);
+    // Drops the binding and the attempt in progress. Unjournaled lifetime changes must be committed first.
+    void ClearSession();
+    // Zeroes every shot's session counters; lifetime bests are kept.
+    void ResetSession();
+
+    void OnShotAttempt(Clock::time_point time, BoostTicks boost_total);
+    // Records the outcome if an attempt is live; outcomes for an attempt that is not live are counted and dropped.
+    void OnOutcome(bool success, Clock::time_point time, BoostTicks boost_total);
+    // A shot reset: the one RepeatCurrentShot causes is absorbed (whether it arrives before or after the next attempt
+    // starts); any other reset is a failed outcome.
+    void OnShotReset(Clock::time_point time, BoostTicks boost_total);
+    // `index` as reported by the game; it wraps around at either end of a pack with `shot_count` shots.
+    void OnShotChanged(int index, int shot_count);
+
+    // True without stats for the current shot, or once it has used up its attempts.
+    bool IsShotFrozen() const;
+
+    int CurrentShot() const { return current_shot_index_; }
+    int MaxAttemptsPerShot() const { return max_attempts_per_shot_; }
+    void SetMaxAttemptsPerShot(int max_attempts) { max_attempts_per_shot_ = max_attempts; }
+    // Boost used by the live attempt so far, given the host's running total now; 0 without a live attempt.
+    BoostTicks AttemptBoostTicks(BoostTicks boost_total) const { return attempt_state_ == AttemptState::Live ? boost_total - attempt_boost_start_ : 0; }
+    AttemptState State() const { return attempt_state_; }
+    // True between RepeatCurrentShot and the shot reset it causes.
+    bool ExpectsSelfReset() const { return expected_self_resets_ > 0; }
+    SessionShotStats& Stats() { return session_stats_; }
+    const SessionShotStats& Stats() const { return session_stats_; }
+
+    // ct_hook_stats
+    uint64_t DuplicateOutcomes() const { return duplicate_outcomes_; }
+    uint64_t SelfResets() const { return self_resets_; }
+    Clock::duration LastOutcomeToAttempt() const { return last_outcome_to_attempt_; }
+    Clock::duration MaxOutcomeToAttempt() const { return max_outcome_to_attempt_; }
+
+    // Folds a finished (or abandoned) run into the shot's lifetime bests; returns true if any field changed.
+    static bool UpdateLifetimeBest(int shot_index, const ShotSessionStats& stats, ShotLifetimeStats& lifetime);
+
+private:
+    void HandleAttempt(bool success, Clock::time_point time, BoostTicks boost_ticks);
+    void ResetCurrentShotSessionStats(ShotSessionStats& stats);
+
+    TrainerHost& host_;
+    int max_attempts_per_shot_ = 10;
+    int current_shot_index_ = 0;
+    AttemptState attempt_state_ = AttemptState::Idle;
+    // The host's boost total when the live attempt started (unsigned, so a wrapped total still subtracts correctly)
+    BoostTicks attempt_boost_start_ = 0;
+    Clock::time_point attempt_start_time_;
+
+    // 1 after RepeatCurrentShot until its shot reset is seen; a shot or session change drops it.
+    int expected_self_resets_ = 0;
+    uint64_t self_resets_ = 0;
+    uint64_t duplicate_outcomes_ = 0;
+    // Outcome observed -> next TrainingShotAttempt
+    Clock::time_point settled_time_;
+    Clock::duration last_outcome_to_attempt_{};
+    Clock::duration max_outcome_to_attempt_{};
+
+    // Stats for each shot index (Local Session): hot session counters, plus a view of the current pack's lifetime bests
+    SessionShotStats session_stats_;
+};
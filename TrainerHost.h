@@ -0,0 +1,23 @@
+#pragma once
+
+#include "AttemptHistory.h"
+#include "ShotStats.h"
+
+// Everything TrainerCore needs from the game. The plugin implements it on top of GameWrapper/CVarManagerWrapper;
+// StandInTrainerHost.h is a scripted stand-in for running the core without the SDK (Linux builds, profiling).
+// All calls come from the thread that drives the core.
+class TrainerHost
+{
+public:
+    virtual ~TrainerHost() = default;
+
+    // An attempt started or was recorded, or the shot or session changed.
+    virtual void OnAttemptStateChanged() = 0;
+    // Called after every recorded attempt to put the shot back.
+    virtual void RepeatCurrentShot() = 0;
+
+    // One recorded attempt, for the attempt history.
+    virtual void RecordAttempt(const AttemptHistory::AttemptRecord& record) = 0;
+    // The shot's lifetime block may have changed (flagged in the session stats if it did); persist it.
+    virtual void CommitLifetime(int shot_index, const ShotLifetimeStats& lifetime) = 0;
+};
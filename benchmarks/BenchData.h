@@ -0,0 +1,41 @@
+#pragma once
+
+// Synthetic lifetime stats shared by the format benchmarks: packs named like training pack codes, with plausible
+// values (a few shots without a successful attempt yet).
+
+#include "ShotStats.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Training pack codes look like "A1B2-C3D4-E5F6-G7H8".
+inline std::string PackCode(int pack)
+{
+    char code[20];
+    std::snprintf(code, sizeof(code), "%04X-%04X-%04X-%04X", pack * 7919 & 0xFFFF, pack * 104729 & 0xFFFF,
+        pack * 1299709 & 0xFFFF, pack & 0xFFFF);
+    return code;
+}
+
+inline PersistentData MakeData(int packs, int shots_per_pack)
+{
+    PersistentData data;
+    uint32_t seed = 12345;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % range;
+    };
+    for (int pack = 0; pack < packs; ++pack) {
+        ShotPackStats& stats = data[PackCode(pack)];
+        for (int shot_index = 0; shot_index < shots_per_pack; ++shot_index) {
+            ShotLifetimeStats& s = stats[shot_index];
+            s.lifetime_attempts_at_best = 1 + static_cast<int>(next(30));
+            s.lifetime_best_successes = static_cast<int>(next(static_cast<uint32_t>(s.lifetime_attempts_at_best) + 1));
+            s.lifetime_total_boost_ticks_at_best = next(50000);
+            s.lifetime_total_successful_boost_ticks_at_best = s.lifetime_total_boost_ticks_at_best / 2;
+            s.lifetime_min_boost_ticks = s.lifetime_best_successes > 0 ? next(400) : NO_BOOST_TICKS;
+        }
+    }
+    return data;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// Helpers shared by the benchmarks: best-of-N wall-clock timing, and a sink that results are folded into and
+// printed at the end, so the optimizer cannot drop the work being measured.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+inline uint64_t g_bench_sink = 0;
+
+// Runs `work` `runs` times and returns the fastest run in seconds.
+template <typename Work>
+double BestSeconds(int runs, Work&& work)
+{
+    double best = 1e300;
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        work();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+inline void PrintSink()
+{
+    std::printf("(sink %llu)\n", static_cast<unsigned long long>(g_bench_sink));
+}
@@ -0,0 +1,76 @@
+// Load time of a monolithic stats file with 10k packs, binary (CTSB, memory-mapped and decoded in place) against
+// text (read into a string and parsed), the two ways LoadMonolithicStats reads ConsistencyTrainer.bin/.data.
+// The files go to the system temp directory and are removed afterwards; the OS cache is warm for both.
+
+#include "MappedFile.h"
+#include "StatsBinaryFormat.h"
+#include "StatsTextFormat.h"
+#include "BenchData.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    void WriteFile(const std::string& path, const std::string& contents)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    // As the plugin reads the text file.
+    std::string ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    void Report(const char* what, size_t bytes, size_t records, double seconds)
+    {
+        std::printf("  %-28s %9.1f MB/s %9.1f ns/record\n", what, bytes / seconds / 1e6, seconds * 1e9 / records);
+    }
+
+    void BenchLoad(int packs, int shots_per_pack)
+    {
+        const PersistentData data = MakeData(packs, shots_per_pack);
+        const size_t records = static_cast<size_t>(packs) * shots_per_pack;
+        const std::filesystem::path dir = std::filesystem::temp_directory_path();
+        const std::string binary_path = (dir / "ct_binary_load_bench.bin").string();
+        const std::string text_path = (dir / "ct_binary_load_bench.data").string();
+        const std::string binary = StatsBinary::Encode(data);
+        const std::string text = SerializeStats(data);
+        WriteFile(binary_path, binary);
+        WriteFile(text_path, text);
+        std::printf("load %d packs, %zu records (%zu bytes binary, %zu bytes text)\n", packs, records, binary.size(), text.size());
+
+        Report("MappedFile + Decode", binary.size(), records, BestSeconds(5, [&] {
+            MappedFile file;
+            PersistentData loaded;
+            std::string error;
+            if (file.Open(binary_path) && StatsBinary::Decode(file.Data(), file.Size(), loaded, error)) {
+                g_bench_sink += loaded.size();
+            }
+        }));
+        Report("read + DeserializeStats", text.size(), records, BestSeconds(5, [&] {
+            g_bench_sink += DeserializeStats(ReadFile(text_path)).size();
+        }));
+
+        std::error_code ec;
+        std::filesystem::remove(binary_path, ec);
+        std::filesystem::remove(text_path, ec);
+    }
+}
+
+int main()
+{
+    BenchLoad(10000, 10);
+    BenchLoad(10000, 50);
+    PrintSink();
+    return 0;
+}
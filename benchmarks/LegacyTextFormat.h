@@ -0,0 +1,105 @@
+#pragma once
+
+// SerializeStats/DeserializeStats as they were before the to_chars/from_chars rewrite (std::stringstream,
+// std::to_string, std::stoi/std::stod, float boost fields), kept as the baseline the text format benchmarks
+// compare against. Only the console log for legacy records is left out.
+
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Legacy
+{
+    struct ShotStats
+    {
+        int attempts = 0;
+        int successes = 0;
+        float total_boost_used = 0.0f;
+        float total_successful_boost_used = 0.0f;
+        float min_successful_boost_used = std::numeric_limits<float>::max();
+
+        int lifetime_best_successes = 0;
+        int lifetime_attempts_at_best = 0;
+        float lifetime_total_boost_at_best = 0.0f;
+        float lifetime_total_successful_boost_at_best = 0.0f;
+        float lifetime_min_boost = std::numeric_limits<float>::max();
+    };
+
+    using PackStats = std::map<int, ShotStats>;
+    using PersistentData = std::map<std::string, PackStats>;
+
+    inline std::string SerializeStats(const PersistentData& data) {
+        std::stringstream ss;
+        for (const auto& pack_pair : data) {
+            for (const auto& shot_pair : pack_pair.second) {
+                ss << pack_pair.first << "|"
+                    << shot_pair.first << "|"
+                    << shot_pair.second.lifetime_best_successes << "|"
+                    << shot_pair.second.lifetime_attempts_at_best << "|"
+                    << std::to_string(shot_pair.second.lifetime_total_boost_at_best) << "|"
+                    << std::to_string(shot_pair.second.lifetime_total_successful_boost_at_best) << "|"
+                    << std::to_string(shot_pair.second.lifetime_min_boost)
+                    << ";";
+            }
+        }
+        std::string result = ss.str();
+        if (!result.empty()) {
+            result.pop_back();
+        }
+        return result;
+    }
+
+    inline PersistentData DeserializeStats(const std::string& str) {
+        PersistentData data;
+        if (str.empty()) return data;
+
+        std::stringstream ss(str);
+        std::string record;
+
+        while (std::getline(ss, record, ';')) {
+            std::stringstream rs(record);
+            std::string segment;
+            std::vector<std::string> segments;
+
+            while (std::getline(rs, segment, '|')) {
+                segments.push_back(segment);
+            }
+
+            if (segments.size() == 7) {
+                std::string pack_id = segments[0];
+                int shot_index = std::stoi(segments[1]);
+                ShotStats s;
+                s.lifetime_best_successes = std::stoi(segments[2]);
+                s.lifetime_attempts_at_best = std::stoi(segments[3]);
+                s.lifetime_total_boost_at_best = std::stod(segments[4]);
+                s.lifetime_total_successful_boost_at_best = std::stod(segments[5]);
+                s.lifetime_min_boost = std::stod(segments[6]);
+
+                s.attempts = 0; s.successes = 0; s.total_boost_used = 0.0;
+                s.total_successful_boost_used = 0.0;
+                s.min_successful_boost_used = std::numeric_limits<float>::max();
+
+                data[pack_id][shot_index] = s;
+            }
+            else if (segments.size() == 6) {
+                std::string pack_id = segments[0];
+                int shot_index = std::stoi(segments[1]);
+                ShotStats s;
+                s.lifetime_best_successes = std::stoi(segments[2]);
+                s.lifetime_attempts_at_best = 10;
+                s.lifetime_total_boost_at_best = std::stod(segments[3]);
+                s.lifetime_total_successful_boost_at_best = std::stod(segments[4]);
+                s.lifetime_min_boost = std::stod(segments[5]);
+
+                s.attempts = 0; s.successes = 0; s.total_boost_used = 0.0;
+                s.total_successful_boost_used = 0.0;
+                s.min_successful_boost_used = std::numeric_limits<float>::max();
+
+                data[pack_id][shot_index] = s;
+            }
+        }
+        return data;
+    }
+}
@@ -0,0 +1,79 @@
+// Cost of a LOG/DEBUGLOG call site with its level filtered out (sink disabled) and with the line formatted into the
+// ring and drained in per-frame batches (sink enabled), against the logging.h it replaced: std::vformat into a
+// std::string, plus the location string for DEBUGLOG, handed by value to the console.
+
+#include "logging.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <format>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    constexpr int CALLS = 2000000;
+    constexpr int CALLS_PER_DRAIN = 256; // The ring holds 512 lines; the plugin drains it every frame
+
+    // Stands in for CVarManagerWrapper::log, which takes the line by value.
+    void LegacyConsole(std::string text) { g_bench_sink += text.size(); }
+    void (*volatile g_legacy_console)(std::string) = &LegacyConsole;
+
+    template <typename... Args>
+    void LegacyLog(std::string_view format_str, Args&&... args)
+    {
+        g_legacy_console(std::vformat(format_str, std::make_format_args(args...)));
+    }
+
+    template <typename... Args>
+    void LegacyDebugLog(std::string_view format_str, const std::source_location& loc, Args&&... args)
+    {
+        auto text = std::vformat(format_str, std::make_format_args(args...));
+        auto location = std::format("[{} ({}:{})]", loc.function_name(), loc.file_name(), loc.line());
+        g_legacy_console(std::format("{} {}", text, location));
+    }
+
+    void Drain()
+    {
+        DrainLog([](LogLevel, std::string_view text) { g_bench_sink += text.size(); });
+    }
+
+    void Report(const char* what, double seconds)
+    {
+        std::printf("  %-32s %8.1f ns/call\n", what, seconds * 1e9 / CALLS);
+    }
+
+    template <typename Call>
+    double TimeCalls(Call&& call)
+    {
+        return BestSeconds(5, [&] {
+            for (int i = 0; i < CALLS; ++i) {
+                call(i);
+                if (i % CALLS_PER_DRAIN == CALLS_PER_DRAIN - 1) Drain();
+            }
+            Drain();
+        });
+    }
+}
+
+int main()
+{
+    const double boost = 12.5;
+
+    std::printf("sink disabled (level filtered)\n");
+    SetLogLevel(LogLevel::Warning);
+    Report("LOG", TimeCalls([&](int i) { LOG("SUCCESS recorded. Attempt {}. Boost Used: {:.1f}", i, boost); }));
+    Report("DEBUGLOG", TimeCalls([&](int i) { DEBUGLOG("Shot {} armed, boost total {}", i, i * 3); }));
+
+    std::printf("sink enabled\n");
+    SetLogLevel(LogLevel::Debug);
+    Report("LOG", TimeCalls([&](int i) { LOG("SUCCESS recorded. Attempt {}. Boost Used: {:.1f}", i, boost); }));
+    Report("DEBUGLOG", TimeCalls([&](int i) { DEBUGLOG("Shot {} armed, boost total {}", i, i * 3); }));
+    Report("legacy LOG", TimeCalls([&](int i) { LegacyLog("SUCCESS recorded. Attempt {}. Boost Used: {:.1f}", i, boost); }));
+    Report("legacy DEBUGLOG", TimeCalls([&](int i) {
+        LegacyDebugLog("Shot {} armed, boost total {}", std::source_location::current(), i, i * 3);
+    }));
+
+    PrintSink();
+    return 0;
+}
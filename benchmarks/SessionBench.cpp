@@ -0,0 +1,124 @@
+// A 500-shot pack played through TrainerCore, whose session stats are a live view into the pack's lifetime table,
+// against the cost the copy-based session it replaced paid on top: copying the whole pack in when it opened, and
+// copying the session map back into the global store after every attempt (LegacyTextFormat.h's ShotStats).
+
+#include "TrainerCore.h"
+#include "StandInTrainerHost.h"
+#include "BenchUtil.h"
+#include "LegacyTextFormat.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    constexpr int SHOTS = 500;
+    constexpr int ATTEMPTS = 200000;
+    constexpr int ATTEMPTS_PER_SHOT = 10;
+
+    void Report(const char* what, size_t operations, double seconds)
+    {
+        std::printf("  %-38s %10.1f ns/op\n", what, seconds * 1e9 / operations);
+    }
+
+    ShotPackStats MakePack()
+    {
+        ShotPackStats pack;
+        for (int shot_index = 0; shot_index < SHOTS; ++shot_index) {
+            ShotLifetimeStats& s = pack[shot_index];
+            s.lifetime_best_successes = shot_index % 8;
+            s.lifetime_attempts_at_best = ATTEMPTS_PER_SHOT;
+            s.lifetime_total_boost_ticks_at_best = static_cast<BoostTicks>(200 + shot_index);
+            s.lifetime_min_boost_ticks = static_cast<BoostTicks>(10 + shot_index % 30);
+        }
+        return pack;
+    }
+
+    // The game's side of a session: attempt, outcome and the self reset, 10 attempts per shot, then the next shot.
+    void PlaySession(TrainerCore& core, StandInTrainerHost& host, int attempts)
+    {
+        TrainerCore::Clock::time_point now{};
+        BoostTicks boost_total = 0;
+        int shot_index = 0;
+        for (int attempt = 1; attempt <= attempts; ++attempt) {
+            core.OnShotAttempt(now, boost_total);
+            boost_total += static_cast<BoostTicks>(attempt * 7 % 90);
+            now += std::chrono::milliseconds(2500);
+            core.OnOutcome(attempt % 3 != 0, now, boost_total);
+            core.OnShotReset(now, boost_total);
+            if (attempt % ATTEMPTS_PER_SHOT == 0) {
+                shot_index = (shot_index + 1) % SHOTS;
+                core.OnShotChanged(shot_index, SHOTS);
+            }
+            // What the plugin does once per frame: hand the log lines and recorded attempts on.
+            if (attempt % 64 == 0) {
+                DrainLogTo(nullptr);
+                host.Clear();
+            }
+        }
+        DrainLogTo(nullptr);
+        host.Clear();
+    }
+
+    void BenchLiveView()
+    {
+        StandInTrainerHost host;
+        TrainerCore core(host);
+        ShotPackStats pack = MakePack();
+
+        const int binds = 20000;
+        Report("BindPack (live view)", binds, BestSeconds(5, [&] {
+            for (int bind = 0; bind < binds; ++bind) {
+                core.BindPack(&pack, SHOTS, 0);
+            }
+            g_bench_sink += core.Stats().size();
+        }));
+
+        Report("attempt through TrainerCore", ATTEMPTS, BestSeconds(5, [&] {
+            core.BindPack(&pack, SHOTS, 0);
+            PlaySession(core, host, ATTEMPTS);
+            g_bench_sink += pack.at(0).lifetime_best_successes;
+        }));
+    }
+
+    void BenchLegacyCopies()
+    {
+        Legacy::PersistentData global;
+        Legacy::PackStats& stored = global["PACK"];
+        for (int shot_index = 0; shot_index < SHOTS; ++shot_index) {
+            stored[shot_index].lifetime_best_successes = shot_index % 8;
+        }
+        Legacy::PackStats session;
+
+        const int binds = 20000;
+        Report("legacy copy-in on pack open", binds, BestSeconds(5, [&] {
+            for (int bind = 0; bind < binds; ++bind) {
+                session.clear();
+                const Legacy::PackStats lifetime = global.at("PACK");
+                for (int shot_index = 0; shot_index < SHOTS; ++shot_index) {
+                    session[shot_index] = lifetime.count(shot_index) ? lifetime.at(shot_index) : Legacy::ShotStats();
+                    session.at(shot_index).attempts = 0;
+                }
+            }
+            g_bench_sink += session.size();
+        }));
+
+        const int attempts = ATTEMPTS / 10;
+        Report("legacy copy-back per attempt", attempts, BestSeconds(5, [&] {
+            for (int attempt = 0; attempt < attempts; ++attempt) {
+                session[attempt % SHOTS].attempts++;
+                global["PACK"] = session;
+            }
+            g_bench_sink += global.at("PACK").size();
+        }));
+    }
+}
+
+int main()
+{
+    std::printf("%d-shot pack, %d attempts per shot\n", SHOTS, ATTEMPTS_PER_SHOT);
+    BenchLiveView();
+    BenchLegacyCopies();
+    PrintSink();
+    return 0;
+}
@@ -0,0 +1,101 @@
+// ShotTable against the std::map<int, ShotStats> it replaced, at typical pack sizes: building a pack, looking up
+// the current shot (every attempt and every displayed line), and walking all shots (display and save).
+
+#include "ShotStats.h"
+#include "BenchUtil.h"
+
+#include <cstdio>
+#include <map>
+#include <vector>
+
+namespace
+{
+    constexpr size_t OPERATIONS = 20000000; // Per measurement, split over as many passes as the pack size needs
+
+    // Shot indices in the order a player might hit them: mostly the same shot, sometimes the next or a jump.
+    std::vector<int> MakeLookupOrder(int shots)
+    {
+        std::vector<int> order(4096);
+        uint32_t seed = 99;
+        int shot = 0;
+        for (int& index : order) {
+            seed = seed * 1664525u + 1013904223u;
+            const uint32_t roll = (seed >> 8) % 10;
+            if (roll == 0) shot = static_cast<int>((seed >> 12) % static_cast<uint32_t>(shots));
+            else if (roll < 3) shot = (shot + 1) % shots;
+            index = shot;
+        }
+        return order;
+    }
+
+    void Report(const char* what, size_t operations, double seconds)
+    {
+        std::printf("  %-34s %8.2f ns/op\n", what, seconds * 1e9 / operations);
+    }
+
+    template <typename Table>
+    void FillTable(Table& table, int shots)
+    {
+        for (int shot_index = 0; shot_index < shots; ++shot_index) {
+            ShotLifetimeStats& s = table[shot_index];
+            s.lifetime_best_successes = shot_index % 5;
+            s.lifetime_total_boost_ticks_at_best = static_cast<BoostTicks>(shot_index * 3);
+        }
+    }
+
+    template <typename Table>
+    void BenchTable(const char* name, int shots)
+    {
+        const std::vector<int> order = MakeLookupOrder(shots);
+        char what[64];
+
+        const size_t builds = OPERATIONS / 10 / static_cast<size_t>(shots);
+        std::snprintf(what, sizeof(what), "%s build (per shot)", name);
+        Report(what, builds * shots, BestSeconds(3, [&] {
+            for (size_t build = 0; build < builds; ++build) {
+                Table table;
+                FillTable(table, shots);
+                g_bench_sink += table.size();
+            }
+        }));
+
+        Table table;
+        FillTable(table, shots);
+
+        std::snprintf(what, sizeof(what), "%s lookup", name);
+        Report(what, OPERATIONS, BestSeconds(3, [&] {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < OPERATIONS; i += order.size()) {
+                for (int shot_index : order) {
+                    ShotLifetimeStats& s = table[shot_index];
+                    s.lifetime_attempts_at_best++;
+                    sum += s.lifetime_best_successes;
+                }
+            }
+            g_bench_sink += sum;
+        }));
+
+        const size_t passes = OPERATIONS / static_cast<size_t>(shots);
+        std::snprintf(what, sizeof(what), "%s iterate (per shot)", name);
+        Report(what, passes * shots, BestSeconds(3, [&] {
+            uint64_t sum = 0;
+            for (size_t pass = 0; pass < passes; ++pass) {
+                for (const auto& shot_pair : table) {
+                    sum += shot_pair.first + shot_pair.second.lifetime_total_boost_ticks_at_best;
+                }
+            }
+            g_bench_sink += sum;
+        }));
+    }
+}
+
+int main()
+{
+    for (int shots : { 10, 100, 1000 }) {
+        std::printf("%d shots\n", shots);
+        BenchTable<ShotTable<ShotLifetimeStats>>("ShotTable", shots);
+        BenchTable<std::map<int, ShotLifetimeStats>>("std::map", shots);
+    }
+    PrintSink();
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Text stats format throughput, current implementation against the stringstream/stoi one it replaced
+// (LegacyTextFormat.h). Both parse the same input; the legacy parser gets text written by the legacy serializer,
+// which is what it read in practice. Serializing is measured into memory and, for WriteStats, into the null device.
+
+#include "StatsTextFormat.h"
+#include "BenchData.h"
+#include "BenchUtil.h"
+#include "LegacyTextFormat.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    Legacy::PersistentData ToLegacy(const PersistentData& data)
+    {
+        Legacy::PersistentData legacy;
+        for (const auto& pack_pair : data) {
+            for (const auto& shot_pair : pack_pair.second) {
+                Legacy::ShotStats& s = legacy[pack_pair.first][shot_pair.first];
+                s.lifetime_best_successes = shot_pair.second.lifetime_best_successes;
+                s.lifetime_attempts_at_best = shot_pair.second.lifetime_attempts_at_best;
+                s.lifetime_total_boost_at_best = BoostTicksToStoredAmount(shot_pair.second.lifetime_total_boost_ticks_at_best);
+                s.lifetime_total_successful_boost_at_best = BoostTicksToStoredAmount(shot_pair.second.lifetime_total_successful_boost_ticks_at_best);
+                s.lifetime_min_boost = BoostTicksToStoredAmount(shot_pair.second.lifetime_min_boost_ticks);
+            }
+        }
+        return legacy;
+    }
+
+    void Report(const char* what, size_t bytes, size_t records, double seconds)
+    {
+        std::printf("  %-28s %9.1f MB/s %9.1f ns/record\n", what, bytes / seconds / 1e6, seconds * 1e9 / records);
+    }
+
+    void BenchParse(int packs, int shots_per_pack)
+    {
+        const PersistentData data = MakeData(packs, shots_per_pack);
+        const size_t records = static_cast<size_t>(packs) * shots_per_pack;
+        const std::string text = SerializeStats(data);
+        const std::string legacy_text = Legacy::SerializeStats(ToLegacy(data));
+        std::printf("parse %zu records (%zu bytes current, %zu bytes legacy)\n", records, text.size(), legacy_text.size());
+
+        const int runs = records >= 100000 ? 3 : 10;
+        Report("DeserializeStats", text.size(), records, BestSeconds(runs, [&] {
+            g_bench_sink += DeserializeStats(text).size();
+        }));
+        Report("legacy DeserializeStats", legacy_text.size(), records, BestSeconds(runs, [&] {
+            g_bench_sink += Legacy::DeserializeStats(legacy_text).size();
+        }));
+    }
+
+    void BenchSerialize(int packs, int shots_per_pack)
+    {
+        const PersistentData data = MakeData(packs, shots_per_pack);
+        const Legacy::PersistentData legacy = ToLegacy(data);
+        const size_t records = static_cast<size_t>(packs) * shots_per_pack;
+        const size_t bytes = SerializeStats(data).size();
+        const size_t legacy_bytes = Legacy::SerializeStats(legacy).size();
+        std::printf("serialize %zu records (%zu bytes current, %zu bytes legacy)\n", records, bytes, legacy_bytes);
+
+#ifdef _WIN32
+        const int null_fd = ::_open("NUL", _O_WRONLY | _O_BINARY);
+#else
+        const int null_fd = ::open("/dev/null", O_WRONLY);
+#endif
+        const int runs = records >= 100000 ? 3 : 10;
+        Report("SerializeStats", bytes, records, BestSeconds(runs, [&] {
+            g_bench_sink += SerializeStats(data).size();
+        }));
+        Report("WriteStats to null device", bytes, records, BestSeconds(runs, [&] {
+            g_bench_sink += WriteStats(null_fd, data);
+        }));
+        Report("legacy SerializeStats", legacy_bytes, records, BestSeconds(runs, [&] {
+            g_bench_sink += Legacy::SerializeStats(legacy).size();
+        }));
+#ifdef _WIN32
+        ::_close(null_fd);
+#else
+        ::close(null_fd);
+#endif
+    }
+}
+
+int main()
+{
+    BenchParse(1, 50);
+    BenchParse(200, 50);
+    BenchParse(1000, 100);
+    BenchSerialize(200, 50);
+    BenchSerialize(10000, 100);
+    PrintSink();
+    return 0;
+}
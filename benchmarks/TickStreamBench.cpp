@@ -0,0 +1,125 @@
+// The per-tick boost path at 120 Hz (Rocket League's physics rate) and 240 Hz (headroom), headless: a stream of
+// SetVehicleInput calls with the boost button held in bursts, an attempt every 2.5 s fed to TrainerCore with the
+// running boost total, as the plugin's hooks do. Compared with the per-tick work the plugin did before the armed
+// state was cached: the enabled flag, the current shot looked up in a std::map to check it is not frozen, and a float
+// accumulator. The SDK calls (IsInCustomTraining, GetLocalCar) the old path also made every tick are not included.
+
+#include "TrainerCore.h"
+#include "StandInTrainerHost.h"
+#include "BenchUtil.h"
+#include "LegacyTextFormat.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr int SECONDS = 600;
+    constexpr double ATTEMPT_SECONDS = 2.5;
+    constexpr int SHOTS = 50;
+
+    // Holding boost for a burst of ticks, then off, roughly a third of the time overall.
+    std::vector<uint8_t> MakeBoostInput(size_t ticks)
+    {
+        std::vector<uint8_t> holding(ticks);
+        uint32_t seed = 17;
+        size_t tick = 0;
+        while (tick < ticks) {
+            seed = seed * 1664525u + 1013904223u;
+            const size_t on = (seed >> 8) % 40;
+            const size_t off = (seed >> 16) % 80;
+            for (size_t i = 0; i < on && tick < ticks; ++i) holding[tick++] = 1;
+            for (size_t i = 0; i < off && tick < ticks; ++i) holding[tick++] = 0;
+        }
+        return holding;
+    }
+
+    void Report(const char* what, size_t ticks, double seconds)
+    {
+        std::printf("  %-30s %8.2f ns/tick %10.1f us per game second\n", what, seconds * 1e9 / ticks, seconds * 1e6 / SECONDS);
+    }
+
+    void BenchRate(int hz)
+    {
+        const size_t ticks = static_cast<size_t>(SECONDS) * hz;
+        const size_t ticks_per_attempt = static_cast<size_t>(ATTEMPT_SECONDS * hz);
+        const std::vector<uint8_t> holding = MakeBoostInput(ticks);
+        std::printf("%d Hz, %d s of play (%zu ticks)\n", hz, SECONDS, ticks);
+
+        // Current path: the hook's armed flag and cached car, a running total, and the total read at each event.
+        StandInTrainerHost host;
+        TrainerCore core(host);
+        ShotPackStats pack;
+        uint64_t charged = 0;
+        uint64_t held = 0;
+        Report("armed path + TrainerCore", ticks, BestSeconds(5, [&] {
+            core.BindPack(&pack, SHOTS, 0);
+            const volatile bool attempt_armed = true;
+            TrainerCore::Clock::time_point now{};
+            BoostTicks boost_total = 0;
+            charged = 0;
+            held = 0;
+            for (size_t tick = 0; tick < ticks; ++tick) {
+                if (tick % ticks_per_attempt == 0) {
+                    if (tick > 0) {
+                        charged += core.AttemptBoostTicks(boost_total);
+                        core.OnOutcome(tick % 3 != 0, now, boost_total);
+                        core.OnShotReset(now, boost_total);
+                        DrainLogTo(nullptr);
+                        host.Clear();
+                    }
+                    core.OnShotAttempt(now, boost_total);
+                }
+                now += std::chrono::microseconds(1000000 / hz);
+                if (!attempt_armed) continue;
+                if (holding[tick]) boost_total++;
+                held += holding[tick];
+            }
+            g_bench_sink += boost_total;
+        }));
+        // Every held tick lands in an attempt, apart from the ones after the last outcome.
+        std::printf("  (%llu of %llu held ticks charged to attempts)\n", static_cast<unsigned long long>(charged),
+            static_cast<unsigned long long>(held));
+
+        Report("armed path alone", ticks, BestSeconds(5, [&] {
+            const volatile bool attempt_armed = true;
+            BoostTicks boost_total = 0;
+            for (size_t tick = 0; tick < ticks; ++tick) {
+                if (!attempt_armed) continue;
+                if (holding[tick]) boost_total++;
+            }
+            g_bench_sink += boost_total;
+        }));
+
+        // Old path: per tick, the plugin flags, a map lookup for IsShotFrozen, and a float add.
+        Legacy::PackStats session;
+        for (int shot_index = 0; shot_index < SHOTS; ++shot_index) session[shot_index];
+        Report("legacy per-tick checks", ticks, BestSeconds(5, [&] {
+            const volatile bool is_plugin_enabled = true;
+            const volatile int current_shot_index = SHOTS / 2;
+            const int max_attempts_per_shot = 10;
+            float current_attempt_boost_used = 0.0f;
+            float sum = 0.0f;
+            for (size_t tick = 0; tick < ticks; ++tick) {
+                if (tick % ticks_per_attempt == 0) {
+                    sum += current_attempt_boost_used;
+                    current_attempt_boost_used = 0.0f;
+                }
+                if (!is_plugin_enabled) continue;
+                auto it = session.find(static_cast<int>(current_shot_index));
+                if (it == session.end() || it->second.attempts >= max_attempts_per_shot) continue;
+                if (session.empty()) continue;
+                if (holding[tick]) current_attempt_boost_used += static_cast<float>(33.333333 / 120.0);
+            }
+            g_bench_sink += static_cast<uint64_t>(sum);
+        }));
+    }
+}
+
+int main()
+{
+    BenchRate(120);
+    BenchRate(240);
+    PrintSink();
+    return 0;
+}
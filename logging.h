@@ -4,84 +4,159 @@
 #include <source_location>
 #include <format>
 #include <memory>
+#include <atomic>
+#include <array>
+#include <type_traits>
+
+#include "LogRing.h"
+
+// No SDK types in here, so the portable core (TrainerCore) logs through the same queue; the plugin drains it to
+// the BakkesMod console (pch.h), a stand-in host to wherever it likes (StandInTrainerHost.h).
+// Compiles DEBUGLOG calls in; whether they print is then up to the runtime level (ct_log_level).
+constexpr bool DEBUG_LOG = true;
+
+// LOG/DEBUGLOG only format and queue a line; DrainLog hands the queue on from the game thread.
+constexpr size_t LOG_LINE_SIZE = 256;
+inline LogRing<512, LOG_LINE_SIZE> g_log_ring;
+inline std::atomic<LogLevel> g_log_level{ LogLevel::Info };
+inline uint64_t g_log_dropped_reported = 0;
+// Per-thread formatting scratch, one character longer than a line so the ring sees (and counts) an overlong line as cut.
+inline thread_local std::array<char, LOG_LINE_SIZE + 1> t_log_buffer;
+inline thread_local std::array<wchar_t, LOG_LINE_SIZE + 1> t_wlog_buffer;
+
+inline void SetLogLevel(LogLevel level)
+{
+	g_log_level.store(level, std::memory_order_relaxed);
+}
 
-#include "bakkesmod/wrappers/cvarmanagerwrapper.h"
-
-extern std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
-constexpr bool DEBUG_LOG = false;
-
+inline bool IsLogLevelEnabled(LogLevel level)
+{
+	return level >= g_log_level.load(std::memory_order_relaxed);
+}
 
-struct FormatString
+inline void PushLogLine(LogLevel level, std::string_view text)
 {
-	std::string_view str;
-	std::source_location loc{};
+	g_log_ring.TryPush(level, text);
+}
 
-	FormatString(const char* str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
+inline void PushLogLine(LogLevel level, std::wstring_view text)
+{
+	// The console line is narrow; anything outside ASCII is replaced rather than transcoded.
+	char narrow[LOG_LINE_SIZE + 1];
+	const size_t length = text.size() < sizeof(narrow) ? text.size() : sizeof(narrow);
+	for (size_t i = 0; i < length; ++i)
 	{
+		narrow[i] = static_cast<uint32_t>(text[i]) < 0x80 ? static_cast<char>(text[i]) : '?';
 	}
+	g_log_ring.TryPush(level, std::string_view(narrow, length));
+}
 
-	FormatString(const std::string&& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
+// Single consumer. Hands every queued line to `sink(level, text)`, then reports lines lost to a full ring since the
+// last drain as one more warning line. Returns the number of queued lines forwarded.
+template <typename Sink>
+size_t DrainLog(Sink&& sink)
+{
+	const size_t count = g_log_ring.Drain(sink);
+	const uint64_t dropped = g_log_ring.DroppedCount();
+	if (dropped != g_log_dropped_reported)
 	{
+		const std::string message = std::to_string(dropped - g_log_dropped_reported) + " log lines dropped (log queue full).";
+		sink(LogLevel::Warning, std::string_view(message));
+		g_log_dropped_reported = dropped;
 	}
+	return count;
+}
+
+
+// Format strings are checked against the argument types at compile time; the source location is captured at the call.
+template <typename... Args>
+struct FormatString
+{
+	std::format_string<Args...> str;
+	std::source_location loc{};
 
-	[[nodiscard]] std::string GetLocation() const
+	template <typename T> requires std::is_convertible_v<const T&, std::string_view>
+	consteval FormatString(const T& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
 	{
-		return std::format("[{} ({}:{})]", loc.function_name(), loc.file_name(), loc.line());
 	}
 };
 
+template <typename... Args>
 struct FormatWstring
 {
-	std::wstring_view str;
+	std::wformat_string<Args...> str;
 	std::source_location loc{};
 
-	FormatWstring(const wchar_t* str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
+	template <typename T> requires std::is_convertible_v<const T&, std::wstring_view>
+	consteval FormatWstring(const T& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
 	{
 	}
+};
 
-	FormatWstring(const std::wstring&& str, const std::source_location& loc = std::source_location::current()) : str(str), loc(loc)
-	{
-	}
 
-	[[nodiscard]] std::wstring GetLocation() const
-	{
-		auto basic_string = std::format("[{} ({}:{})]", loc.function_name(), loc.file_name(), loc.line());
-		return std::wstring(basic_string.begin(), basic_string.end());
-	}
-};
+// Formatting goes straight into the thread's buffer: no std::string is built on the way to the ring.
+template <typename... Args>
+void LOG(LogLevel level, std::format_string<Args...> format_str, Args&&... args)
+{
+	if (!IsLogLevelEnabled(level)) return;
+	auto& buffer = t_log_buffer;
+	const auto result = std::format_to_n(buffer.data(), buffer.size(), format_str, std::forward<Args>(args)...);
+	PushLogLine(level, std::string_view(buffer.data(), result.out - buffer.data()));
+}
 
+template <typename... Args>
+void LOG(LogLevel level, std::wformat_string<Args...> format_str, Args&&... args)
+{
+	if (!IsLogLevelEnabled(level)) return;
+	auto& buffer = t_wlog_buffer;
+	const auto result = std::format_to_n(buffer.data(), buffer.size(), format_str, std::forward<Args>(args)...);
+	PushLogLine(level, std::wstring_view(buffer.data(), result.out - buffer.data()));
+}
 
 template <typename... Args>
-void LOG(std::string_view format_str, Args&&... args)
+void LOG(std::format_string<Args...> format_str, Args&&... args)
 {
-	_globalCvarManager->log(std::vformat(format_str, std::make_format_args(args...)));
+	LOG(LogLevel::Info, format_str, std::forward<Args>(args)...);
 }
 
 template <typename... Args>
-void LOG(std::wstring_view format_str, Args&&... args)
+void LOG(std::wformat_string<Args...> format_str, Args&&... args)
 {
-	_globalCvarManager->log(std::vformat(format_str, std::make_wformat_args(args...)));
+	LOG(LogLevel::Info, format_str, std::forward<Args>(args)...);
 }
 
 
 template <typename... Args>
-void DEBUGLOG(const FormatString& format_str, Args&&... args)
+void DEBUGLOG(FormatString<std::type_identity_t<Args>...> format_str, Args&&... args)
 {
 	if constexpr (DEBUG_LOG)
 	{
-		auto text = std::vformat(format_str.str, std::make_format_args(args...));
-		auto location = format_str.GetLocation();
-		_globalCvarManager->log(std::format("{} {}", text, location));
+		if (!IsLogLevelEnabled(LogLevel::Debug)) return;
+		auto& buffer = t_log_buffer;
+		const auto text = std::format_to_n(buffer.data(), buffer.size(), format_str.str, std::forward<Args>(args)...);
+		const auto& loc = format_str.loc;
+		const auto line = std::format_to_n(text.out, buffer.size() - (text.out - buffer.data()), " [{} ({}:{})]",
+			loc.function_name(), loc.file_name(), loc.line());
+		PushLogLine(LogLevel::Debug, std::string_view(buffer.data(), line.out - buffer.data()));
 	}
 }
 
 template <typename... Args>
-void DEBUGLOG(const FormatWstring& format_str, Args&&... args)
+void DEBUGLOG(FormatWstring<std::type_identity_t<Args>...> format_str, Args&&... args)
 {
 	if constexpr (DEBUG_LOG)
 	{
-		auto text = std::vformat(format_str.str, std::make_wformat_args(args...));
-		auto location = format_str.GetLocation();
-		_globalCvarManager->log(std::format(L"{} {}", text, location));
+		if (!IsLogLevelEnabled(LogLevel::Debug)) return;
+		auto& buffer = t_wlog_buffer;
+		const auto text = std::format_to_n(buffer.data(), buffer.size(), format_str.str, std::forward<Args>(args)...);
+		const auto& loc = format_str.loc;
+		// The location strings are narrow; widen them character by character as the old GetLocation did.
+		auto out = std::format_to_n(text.out, buffer.size() - (text.out - buffer.data()), L" [").out;
+		for (const char* part : { loc.function_name(), " (", loc.file_name() })
+		{
+			for (; *part != '\0' && out != buffer.data() + buffer.size(); ++part) *out++ = static_cast<wchar_t>(*part);
+		}
+		out = std::format_to_n(out, buffer.size() - (out - buffer.data()), L":{})]", loc.line()).out;
+		PushLogLine(LogLevel::Debug, std::wstring_view(buffer.data(), out - buffer.data()));
 	}
 }
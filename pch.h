@@ -14,4 +14,13 @@
 #include "IMGUI/imgui_searchablecombo.h"
 #include "IMGUI/imgui_rangeslider.h"
 
-#include "logging.h"
\ No newline at end of file
+#include "logging.h"
+
+extern std::shared_ptr<CVarManagerWrapper> _globalCvarManager;
+
+// Game thread only: forwards the queued LOG lines to the console. Returns the number of lines forwarded.
+inline size_t DrainLog()
+{
+    if (!_globalCvarManager) return 0;
+    return DrainLog([](LogLevel, std::string_view text) { _globalCvarManager->log(std::string(text)); });
+}
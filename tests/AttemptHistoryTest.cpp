@@ -0,0 +1,178 @@
+// Attempt history frames: varint and zigzag edge cases, and resynchronization past torn or corrupt frames.
+
+#include "AttemptHistory.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+using AttemptHistory::AttemptRecord;
+
+namespace
+{
+    AttemptRecord MakeRecord(int shot_index, int64_t timestamp_ms, bool success, float boost_used, uint32_t duration_ms)
+    {
+        AttemptRecord record;
+        record.shot_index = shot_index;
+        record.timestamp_ms = timestamp_ms;
+        record.success = success;
+        record.boost_used = boost_used;
+        record.duration_ms = duration_ms;
+        return record;
+    }
+
+    bool SameRecord(const AttemptRecord& a, const AttemptRecord& b)
+    {
+        return a.shot_index == b.shot_index && a.timestamp_ms == b.timestamp_ms && a.success == b.success
+            && a.boost_used == b.boost_used && a.duration_ms == b.duration_ms;
+    }
+
+    std::vector<AttemptRecord> DecodeAll(const std::string& bytes, AttemptHistory::DecodeReport& report)
+    {
+        std::vector<AttemptRecord> records;
+        AttemptHistory::Decode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(),
+            [&records](const AttemptRecord& record) { records.push_back(record); }, &report);
+        return records;
+    }
+
+    bool SameRecords(const std::vector<AttemptRecord>& a, const std::vector<AttemptRecord>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (!SameRecord(a[i], b[i])) return false;
+        }
+        return true;
+    }
+
+    std::vector<AttemptRecord> SampleRecords(int64_t base, int count)
+    {
+        std::vector<AttemptRecord> records;
+        for (int i = 0; i < count; ++i) {
+            records.push_back(MakeRecord(i % 7, base + i * 4500, i % 3 == 0, static_cast<float>(i) * 1.25f, 3000u + i));
+        }
+        return records;
+    }
+
+    void TestVarintEdgeCases()
+    {
+        // Timestamp deltas straddle the 1, 2 and 3 byte varint boundaries (after zigzag and the success bit) in both
+        // directions, including a clock that steps backwards.
+        const int64_t base = 1767225600000; // 2026-01-01, needs 6 varint bytes
+        std::vector<AttemptRecord> records = { MakeRecord(0, base, false, 0.0f, 0) };
+        int64_t timestamp = base;
+        for (int64_t delta : { 0, 31, 32, -32, -33, 4095, 4096, -4096, -4097, 524287, 524288, -524288, -524289 }) {
+            timestamp += delta;
+            records.push_back(MakeRecord(static_cast<int>(records.size()), timestamp, delta % 2 != 0, 1.0f, 0));
+        }
+        // Other fields at their varint boundaries and maximums.
+        records.push_back(MakeRecord(127, timestamp, true, 1.27f, 127));
+        records.push_back(MakeRecord(128, timestamp, true, 1.28f, 128));
+        records.push_back(MakeRecord(4095, timestamp, false, 100.0f, 16384));
+        records.push_back(MakeRecord(std::numeric_limits<int>::max(), timestamp, true, 0.01f,
+            std::numeric_limits<uint32_t>::max()));
+        // Jumps of decades either way.
+        records.push_back(MakeRecord(1, timestamp + (int64_t(1) << 40), false, 0.0f, 1));
+        records.push_back(MakeRecord(2, 0, true, 0.0f, 2));
+
+        AttemptHistory::DecodeReport report;
+        const std::vector<AttemptRecord> decoded = DecodeAll(AttemptHistory::EncodeFrame(records), report);
+        CHECK(report.frames == 1);
+        CHECK(report.records == records.size());
+        CHECK(report.skipped_bytes == 0);
+        CHECK(SameRecords(decoded, records));
+    }
+
+    void TestLargeAndNegativeBaseTimestamps()
+    {
+        for (int64_t base : { int64_t(0), int64_t(-5000), std::numeric_limits<int64_t>::max() / 4 }) {
+            const std::vector<AttemptRecord> records = SampleRecords(base, 5);
+            AttemptHistory::DecodeReport report;
+            CHECK(SameRecords(DecodeAll(AttemptHistory::EncodeFrame(records), report), records));
+        }
+    }
+
+    void TestValuesClampedOnEncode()
+    {
+        // Negative shot indices and boost cannot be stored; they read back as 0. Boost keeps two decimals.
+        const std::vector<AttemptRecord> records = { MakeRecord(-3, 1000, true, -2.5f, 10), MakeRecord(1, 1000, true, 12.345f, 10) };
+        AttemptHistory::DecodeReport report;
+        const std::vector<AttemptRecord> decoded = DecodeAll(AttemptHistory::EncodeFrame(records), report);
+        CHECK(decoded.size() == 2);
+        if (decoded.size() == 2) {
+            CHECK(decoded[0].shot_index == 0);
+            CHECK(decoded[0].boost_used == 0.0f);
+            CHECK(decoded[1].boost_used == 12.35f || decoded[1].boost_used == 12.34f);
+        }
+    }
+
+    void TestEmptyFrame()
+    {
+        AttemptHistory::DecodeReport report;
+        CHECK(DecodeAll(AttemptHistory::EncodeFrame({}), report).empty());
+        CHECK(report.frames == 1);
+        CHECK(report.records == 0);
+        CHECK(report.skipped_bytes == 0);
+    }
+
+    void TestTornFrameSkipped()
+    {
+        const std::vector<AttemptRecord> first = SampleRecords(1000000, 4);
+        const std::vector<AttemptRecord> torn = SampleRecords(2000000, 30);
+        const std::vector<AttemptRecord> last = SampleRecords(3000000, 3);
+        const std::string torn_frame = AttemptHistory::EncodeFrame(torn);
+
+        std::vector<AttemptRecord> expected = first;
+        expected.insert(expected.end(), last.begin(), last.end());
+
+        // A crash mid-append leaves any prefix of the frame; the next session appends after it.
+        for (size_t cut = 1; cut < torn_frame.size(); ++cut) {
+            const std::string bytes = AttemptHistory::EncodeFrame(first) + torn_frame.substr(0, cut) + AttemptHistory::EncodeFrame(last);
+            AttemptHistory::DecodeReport report;
+            CHECK(SameRecords(DecodeAll(bytes, report), expected));
+            CHECK(report.frames == 2);
+            CHECK(report.skipped_bytes == cut);
+        }
+
+        // A torn frame at the end of the file.
+        const std::string bytes = AttemptHistory::EncodeFrame(first) + torn_frame.substr(0, torn_frame.size() / 2);
+        AttemptHistory::DecodeReport report;
+        CHECK(SameRecords(DecodeAll(bytes, report), first));
+        CHECK(report.skipped_bytes == torn_frame.size() / 2);
+    }
+
+    void TestCorruptFrameSkipped()
+    {
+        const std::string first = AttemptHistory::EncodeFrame(SampleRecords(1000, 5));
+        const std::string middle = AttemptHistory::EncodeFrame(SampleRecords(2000, 5));
+        const std::string last = AttemptHistory::EncodeFrame(SampleRecords(3000, 5));
+
+        for (size_t offset = 0; offset < middle.size(); ++offset) {
+            std::string damaged = middle;
+            damaged[offset] ^= 0x04;
+            AttemptHistory::DecodeReport report;
+            const std::vector<AttemptRecord> decoded = DecodeAll(first + damaged + last, report);
+            CHECK(report.frames == 2);
+            CHECK(report.records == 10);
+            CHECK(report.skipped_bytes == middle.size());
+            CHECK(decoded.size() == 10);
+        }
+
+        // Garbage in front of the first frame is skipped the same way.
+        AttemptHistory::DecodeReport report;
+        CHECK(DecodeAll("xyzCC\x01" + first, report).size() == 5);
+        CHECK(report.skipped_bytes == 6);
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestVarintEdgeCases);
+    RUN_TEST(TestLargeAndNegativeBaseTimestamps);
+    RUN_TEST(TestValuesClampedOnEncode);
+    RUN_TEST(TestEmptyFrame);
+    RUN_TEST(TestTornFrameSkipped);
+    RUN_TEST(TestCorruptFrameSkipped);
+    return TestResult();
+}
@@ -0,0 +1,170 @@
+// Boost delta mode replayed against tick counting on synthetic attempts: the car's boost amount is simulated per
+// input tick (as the component stores it, a float fraction of a tank), and the meter is driven the way the
+// plugin's hooks drive it, including the fall back to counting ticks after a refill the hooks did not see.
+
+#include "BoostDeltaMeter.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace
+{
+    class ReplayedAttempt
+    {
+    public:
+        explicit ReplayedAttempt(float tank_fraction) : fraction_(tank_fraction)
+        {
+            meter_.Start(Amount());
+        }
+
+        // One SetVehicleInput tick.
+        void Tick(bool holding_boost)
+        {
+            if (!holding_boost) return;
+            held_ticks_++;
+            if (fallback_) counted_ticks_++;
+            if (fraction_ > 0.0f) {
+                fraction_ = std::max(0.0f, fraction_ - static_cast<float>(BOOST_AMOUNT_PER_TICK / 100.0));
+                used_ticks_++;
+            }
+        }
+        void Hold(int ticks)
+        {
+            for (int tick = 0; tick < ticks; ++tick) Tick(true);
+        }
+
+        // A boost pad, seen by the refill hooks (OnBoostRefill before and after) or not.
+        void Pickup(float tank_fraction, bool tracked)
+        {
+            if (tracked && meter_.IsActive() && !meter_.BeforeRefill(Amount())) FallBack();
+            fraction_ = std::min(1.0f, fraction_ + tank_fraction);
+            if (tracked) meter_.AfterRefill(Amount());
+        }
+
+        // The outcome: SettleBoostMeasurement. Returns the ticks the attempt is charged.
+        BoostTicks Settle()
+        {
+            if (meter_.IsActive() && !meter_.Sample(Amount())) settled_with_rise_ = true;
+            return meter_.Stop() + counted_ticks_;
+        }
+
+        int HeldTicks() const { return held_ticks_; }
+        int UsedTicks() const { return used_ticks_; }
+        bool FellBack() const { return fallback_; }
+        bool SettledWithRise() const { return settled_with_rise_; }
+
+    private:
+        float Amount() const { return fraction_ * 100.0f; }
+        void FallBack()
+        {
+            counted_ticks_ += meter_.Stop();
+            fallback_ = true;
+        }
+
+        BoostDeltaMeter meter_;
+        float fraction_;
+        int held_ticks_ = 0;      // What tick counting charges
+        int used_ticks_ = 0;      // Ticks in which boost was actually drained
+        BoostTicks counted_ticks_ = 0;
+        bool fallback_ = false;
+        bool settled_with_rise_ = false;
+    };
+
+    bool WithinOneTick(BoostTicks measured, int ticks)
+    {
+        return std::abs(static_cast<int>(measured) - ticks) <= 1;
+    }
+
+    void TestMatchesTickCountingWithoutPickups()
+    {
+        for (int ticks : { 0, 1, 2, 37, 120, 359 }) {
+            ReplayedAttempt attempt(1.0f);
+            attempt.Hold(ticks);
+            CHECK(WithinOneTick(attempt.Settle(), attempt.HeldTicks()));
+        }
+
+        // Bursts with gaps, starting from a part-empty tank.
+        ReplayedAttempt attempt(0.334f);
+        for (int burst = 0; burst < 8; ++burst) {
+            attempt.Hold(9);
+            for (int gap = 0; gap < 20; ++gap) attempt.Tick(false);
+        }
+        CHECK(attempt.HeldTicks() == 72);
+        CHECK(WithinOneTick(attempt.Settle(), 72));
+    }
+
+    void TestTrackedPickupsNotCountedAsUse()
+    {
+        ReplayedAttempt attempt(0.5f);
+        attempt.Hold(40);
+        attempt.Pickup(0.12f, true);
+        attempt.Hold(100);
+        attempt.Pickup(1.0f, true);
+        attempt.Pickup(0.12f, true); // Already full
+        attempt.Hold(25);
+        CHECK(!attempt.FellBack());
+        CHECK(attempt.HeldTicks() == 165);
+        CHECK(WithinOneTick(attempt.Settle(), 165));
+    }
+
+    void TestUntrackedPickupFallsBackToTicks()
+    {
+        // The next tracked refill notices the amount went up; the meter keeps what it measured up to its last
+        // reading and ticks are counted from there on. (An unseen refill smaller than the boost used after it
+        // cannot be noticed at all; the attempt is then undercounted by the refill.)
+        ReplayedAttempt attempt(0.5f);
+        attempt.Hold(30);
+        attempt.Pickup(0.3f, false);
+        attempt.Hold(30);
+        attempt.Pickup(0.12f, true);
+        CHECK(attempt.FellBack());
+        attempt.Hold(50);
+        const BoostTicks measured = attempt.Settle();
+        // The ticks between the start and the unseen refill are lost: a lower bound, exact from the fallback on.
+        CHECK(measured >= 50);
+        CHECK(static_cast<int>(measured) <= attempt.HeldTicks());
+
+        // Only noticed at the outcome: what was measured before the refill is all the attempt gets.
+        ReplayedAttempt late(0.5f);
+        late.Hold(30);
+        late.Pickup(0.3f, false);
+        late.Hold(10);
+        const BoostTicks settled = late.Settle();
+        CHECK(late.SettledWithRise());
+        CHECK(static_cast<int>(settled) <= late.HeldTicks());
+    }
+
+    void TestEmptyTankUsesNothing()
+    {
+        // Holding boost with an empty tank burns nothing. The meter sees that; tick counting charges every tick.
+        ReplayedAttempt attempt(0.1f);
+        attempt.Hold(100);
+        CHECK(attempt.UsedTicks() < attempt.HeldTicks());
+        CHECK(WithinOneTick(attempt.Settle(), attempt.UsedTicks()));
+    }
+
+    void TestStoppedMeterChargesNothing()
+    {
+        BoostDeltaMeter meter;
+        CHECK(meter.Stop() == 0);
+        CHECK(meter.Sample(50.0f));
+        meter.Start(80.0f);
+        CHECK(meter.Sample(70.0f));
+        CHECK(meter.Stop() == BoostAmountToTicks(10.0));
+        // A second outcome for the same attempt finds it stopped.
+        CHECK(!meter.IsActive());
+        CHECK(meter.Stop() == 0);
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestMatchesTickCountingWithoutPickups);
+    RUN_TEST(TestTrackedPickupsNotCountedAsUse);
+    RUN_TEST(TestUntrackedPickupFallsBackToTicks);
+    RUN_TEST(TestEmptyTankUsesNothing);
+    RUN_TEST(TestStoppedMeterChargesNothing);
+    return TestResult();
+}
@@ -0,0 +1,120 @@
+// Integer boost ticks against the float boost units they replaced: values written by the float-based plugin read
+// back as the ticks that produced them, stored amounts round-trip, and tick sums and minimums are exact.
+
+#include "StatsTextFormat.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // How the float-based plugin measured an attempt: BOOST_AMOUNT_PER_TICK added to a float on every boosting tick.
+    float LegacyAttemptAmount(int ticks)
+    {
+        float used = 0.0f;
+        for (int tick = 0; tick < ticks; ++tick) {
+            used += BOOST_AMOUNT_PER_TICK;
+        }
+        return used;
+    }
+
+    // One record as the float-based plugin wrote it (std::to_string: six decimals).
+    std::string LegacyRecord(int shot_index, float total, float successful, float min)
+    {
+        return "P|" + std::to_string(shot_index) + "|1|1|" + std::to_string(total) + "|" + std::to_string(successful)
+            + "|" + std::to_string(min);
+    }
+
+    void TestStoredAmountsRoundTrip()
+    {
+        // Every tick count up to 2^23 (over 19 hours of boosting) survives the float boost units the files hold.
+        for (BoostTicks ticks = 0; ticks < (1u << 23); ++ticks) {
+            if (BoostAmountToTicks(BoostTicksToStoredAmount(ticks)) != ticks) {
+                CHECK(BoostAmountToTicks(BoostTicksToStoredAmount(ticks)) == ticks);
+                break;
+            }
+        }
+        CHECK(BoostAmountToTicks(BoostTicksToStoredAmount(NO_BOOST_TICKS)) == NO_BOOST_TICKS);
+        CHECK(BoostAmountToTicks(std::numeric_limits<float>::max()) == NO_BOOST_TICKS);
+        CHECK(BoostAmountToTicks(-1.0) == 0);
+        CHECK(BoostAmountToTicks(std::nan("")) == 0);
+    }
+
+    void TestLegacyAttemptsReadAsTheirTicks()
+    {
+        // A single attempt, from a tap up to more than three full tanks.
+        std::string text;
+        for (int ticks = 0; ticks <= 1200; ++ticks) {
+            const float amount = LegacyAttemptAmount(ticks);
+            if (!text.empty()) text += ';';
+            text += LegacyRecord(ticks, amount, amount, amount);
+        }
+        StatsParseReport report;
+        const PersistentData data = DeserializeStats(text, &report);
+        CHECK(report.malformed_records == 0);
+        const ShotPackStats& pack = data.at("P");
+        for (int ticks = 0; ticks <= 1200; ++ticks) {
+            const ShotLifetimeStats& s = pack.at(ticks);
+            if (s.lifetime_total_boost_ticks_at_best != static_cast<BoostTicks>(ticks) || s.lifetime_min_boost_ticks != static_cast<BoostTicks>(ticks)) {
+                CHECK(s.lifetime_total_boost_ticks_at_best == static_cast<BoostTicks>(ticks));
+                CHECK(s.lifetime_min_boost_ticks == static_cast<BoostTicks>(ticks));
+                break;
+            }
+        }
+    }
+
+    void TestLegacyRunTotalsWithinRounding()
+    {
+        // A ten-attempt run total was a float sum of float attempt amounts; it reads back within a tick of the true
+        // count, while the tick-based sum of the same attempts is exact.
+        uint32_t seed = 3;
+        for (int run = 0; run < 2000; ++run) {
+            float legacy_total = 0.0f;
+            float legacy_min = std::numeric_limits<float>::max();
+            BoostTicks total = 0;
+            BoostTicks min = NO_BOOST_TICKS;
+            for (int attempt = 0; attempt < 10; ++attempt) {
+                seed = seed * 1664525u + 1013904223u;
+                const int ticks = static_cast<int>((seed >> 8) % 700);
+                legacy_total += LegacyAttemptAmount(ticks);
+                legacy_min = std::min(legacy_min, LegacyAttemptAmount(ticks));
+                total += static_cast<BoostTicks>(ticks);
+                min = std::min(min, static_cast<BoostTicks>(ticks));
+            }
+
+            const PersistentData data = DeserializeStats(LegacyRecord(0, legacy_total, legacy_total, legacy_min));
+            const ShotLifetimeStats& s = data.at("P").at(0);
+            const int64_t difference = static_cast<int64_t>(s.lifetime_total_boost_ticks_at_best) - static_cast<int64_t>(total);
+            CHECK(difference >= -1 && difference <= 1);
+            CHECK(s.lifetime_min_boost_ticks == min);
+        }
+    }
+
+    void TestTickSumsAreExact()
+    {
+        // A session's worth of one-tick taps: the float accumulator drifts, the tick count cannot.
+        constexpr int TAPS = 1000000;
+        BoostTicks total = 0;
+        float legacy_total = 0.0f;
+        for (int tap = 0; tap < TAPS; ++tap) {
+            total += 1;
+            legacy_total += LegacyAttemptAmount(1);
+        }
+        CHECK(total == static_cast<BoostTicks>(TAPS));
+        CHECK(std::fabs(legacy_total - TAPS * BOOST_AMOUNT_PER_TICK) > BOOST_AMOUNT_PER_TICK);
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestStoredAmountsRoundTrip);
+    RUN_TEST(TestLegacyAttemptsReadAsTheirTicks);
+    RUN_TEST(TestLegacyRunTotalsWithinRounding);
+    RUN_TEST(TestTickSumsAreExact);
+    return TestResult();
+}
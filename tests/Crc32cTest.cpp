@@ -0,0 +1,76 @@
+// CRC-32C check values, and the active implementation (SSE4.2 or table) against a bit-by-bit reference.
+
+#include "Crc32c.h"
+#include "TestCheck.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    uint32_t ReferenceCrc32c(const uint8_t* data, size_t size)
+    {
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1u) ? 0x82F63B78u : 0u);
+            }
+        }
+        return ~crc;
+    }
+
+    void TestCheckValues()
+    {
+        CHECK(Crc32c("123456789", 9) == 0xE3069283u);
+        CHECK(Crc32c("", 0) == 0u);
+
+        // RFC 3720 (iSCSI), appendix B.4.
+        std::array<uint8_t, 32> bytes{};
+        CHECK(Crc32c(bytes.data(), bytes.size()) == 0x8A9136AAu);
+        bytes.fill(0xFF);
+        CHECK(Crc32c(bytes.data(), bytes.size()) == 0x62A8AB43u);
+        for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(i);
+        CHECK(Crc32c(bytes.data(), bytes.size()) == 0x46DD794Eu);
+        for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(31 - i);
+        CHECK(Crc32c(bytes.data(), bytes.size()) == 0x113FDB5Cu);
+    }
+
+    void TestMatchesReferenceAtEveryAlignment()
+    {
+        std::vector<uint8_t> buffer(1024 + 8);
+        uint32_t seed = 1;
+        for (uint8_t& byte : buffer) {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<uint8_t>(seed >> 24);
+        }
+
+        for (size_t offset = 0; offset < 8; ++offset) {
+            for (size_t size = 0; size <= 1024; size += (size < 64 ? 1 : 61)) {
+                CHECK(Crc32c(buffer.data() + offset, size) == ReferenceCrc32c(buffer.data() + offset, size));
+            }
+        }
+    }
+
+    void TestContinuation()
+    {
+        const char* text = "The quick brown fox jumps over the lazy dog";
+        const size_t size = std::strlen(text);
+        const uint32_t whole = Crc32c(text, size);
+        for (size_t split = 0; split <= size; ++split) {
+            CHECK(Crc32c(text + split, size - split, Crc32c(text, split)) == whole);
+        }
+    }
+}
+
+int main()
+{
+    std::printf("hardware accelerated: %s\n", Crc32cIsHardwareAccelerated() ? "yes" : "no");
+    RUN_TEST(TestCheckValues);
+    RUN_TEST(TestMatchesReferenceAtEveryAlignment);
+    RUN_TEST(TestContinuation);
+    return TestResult();
+}
@@ -0,0 +1,302 @@
+// Shard and index recovery: torn, empty, corrupt or misnamed current files fall back to older generations,
+// and a writer killed mid-save (Linux/POSIX) always leaves a loadable snapshot behind.
+
+#include "PackShardStore.h"
+#include "PersistenceWriter.h"
+#include "StatsBinaryFormat.h"
+#include "TempDirectory.h"
+#include "TestCheck.h"
+
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr int GENERATIONS = 3; // As the plugin keeps them
+
+    ShotLifetimeStats MakeLifetime(int version, int shot_index)
+    {
+        ShotLifetimeStats lifetime;
+        lifetime.lifetime_best_successes = version;
+        lifetime.lifetime_attempts_at_best = shot_index;
+        lifetime.lifetime_total_boost_ticks_at_best = static_cast<BoostTicks>(version * 7 + shot_index);
+        lifetime.lifetime_min_boost_ticks = static_cast<BoostTicks>(version + shot_index);
+        return lifetime;
+    }
+
+    ShotPackStats MakePack(int version, int shot_count)
+    {
+        ShotPackStats pack;
+        for (int shot_index = 0; shot_index < shot_count; ++shot_index) {
+            pack[shot_index] = MakeLifetime(version, shot_index);
+        }
+        return pack;
+    }
+
+    // The version MakePack wrote, or -1 if the shots disagree.
+    int PackVersion(const ShotPackStats& pack)
+    {
+        int version = -1;
+        for (const auto& shot_pair : pack) {
+            const int shot_version = shot_pair.second.lifetime_best_successes;
+            if (version != -1 && shot_version != version) return -1;
+            if (shot_pair.second != MakeLifetime(shot_version, shot_pair.first)) return -1;
+            version = shot_version;
+        }
+        return version;
+    }
+
+    // What SavePersistentStats hands the writer for one pack.
+    bool SavePack(PackShardStore& store, PersistenceWriter& writer, const std::string& name, const ShotPackStats& stats)
+    {
+        const PackId id = store.Intern(name);
+        store.UpdateEncoding(id, stats, nullptr);
+        std::vector<PersistenceWriter::FileSnapshot> files;
+        files.push_back({ store.GetShardPath(id), [name, records = store.GetEncodedRecords(id)]() {
+            return StatsBinary::EncodePack(name, records);
+        } });
+        if (store.IsIndexDirty()) {
+            files.push_back({ store.GetIndexPath(), [index = store.EncodeIndex()]() { return index; } });
+            store.MarkIndexClean();
+        }
+        writer.RequestSave(std::move(files));
+        return writer.Flush();
+    }
+
+    // Two saves of "PACK": version 1 ends up in "0.bin.1", version 2 in "0.bin".
+    void SaveTwoVersions(const TempDirectory& dir)
+    {
+        PackShardStore store(dir.Path(), GENERATIONS);
+        std::string warning;
+        store.LoadIndex(warning);
+        PersistenceWriter writer("", GENERATIONS);
+        CHECK(SavePack(store, writer, "PACK", MakePack(1, 20)));
+        CHECK(SavePack(store, writer, "PACK", MakePack(2, 20)));
+    }
+
+    // Loads "PACK" the way InitializeSessionStats does; returns its version, or -1 if nothing loaded.
+    int LoadPackVersion(const TempDirectory& dir, int& generation, std::string& error)
+    {
+        PackShardStore store(dir.Path(), GENERATIONS);
+        std::string warning;
+        PackId id = 0;
+        if (!store.LoadIndex(warning) || !store.Find("PACK", id)) return -1;
+        ShotPackStats loaded;
+        if (!store.LoadShard(id, loaded, generation, error)) return -1;
+        return PackVersion(loaded);
+    }
+
+    void TestCurrentShardLoads()
+    {
+        TempDirectory dir;
+        SaveTwoVersions(dir);
+        int generation = -1;
+        std::string error;
+        CHECK(LoadPackVersion(dir, generation, error) == 2);
+        CHECK(generation == 0);
+        CHECK(error.empty());
+    }
+
+    void TestTornShardFallsBack()
+    {
+        TempDirectory dir;
+        SaveTwoVersions(dir);
+        const std::string shard = dir.File("0.bin");
+        const std::string intact = ReadWholeFile(shard);
+
+        // Cut anywhere: inside the header, the directory, the records or the string table.
+        for (size_t size : { size_t(0), size_t(10), StatsBinary::HEADER_SIZE, intact.size() / 2, intact.size() - 1 }) {
+            WriteWholeFile(shard, intact.substr(0, size));
+            int generation = -1;
+            std::string error;
+            CHECK(LoadPackVersion(dir, generation, error) == 1);
+            CHECK(generation == 1);
+            CHECK(!error.empty());
+        }
+    }
+
+    void TestCorruptShardFallsBack()
+    {
+        TempDirectory dir;
+        SaveTwoVersions(dir);
+        const std::string shard = dir.File("0.bin");
+        std::string corrupt = ReadWholeFile(shard);
+        corrupt[StatsBinary::HEADER_SIZE + 40] ^= 0x01;
+        WriteWholeFile(shard, corrupt);
+
+        int generation = -1;
+        std::string error;
+        CHECK(LoadPackVersion(dir, generation, error) == 1);
+        CHECK(generation == 1);
+    }
+
+    void TestMisnamedShardRejected()
+    {
+        TempDirectory dir;
+        SaveTwoVersions(dir);
+        PersistentData other;
+        other["OTHER"] = MakePack(9, 3);
+        WriteWholeFile(dir.File("0.bin"), StatsBinary::Encode(other));
+
+        int generation = -1;
+        std::string error;
+        CHECK(LoadPackVersion(dir, generation, error) == 1);
+        CHECK(error.find("OTHER") != std::string::npos);
+
+        // With no good generation left the load fails rather than handing back another pack's stats.
+        WriteWholeFile(dir.File("0.bin.1"), StatsBinary::Encode(other));
+        CHECK(LoadPackVersion(dir, generation, error) == -1);
+    }
+
+    void TestUnsavedPackLoadsEmpty()
+    {
+        TempDirectory dir;
+        PackShardStore store(dir.Path(), GENERATIONS);
+        const PackId id = store.Intern("NEW");
+        ShotPackStats loaded = MakePack(1, 3);
+        int generation = -1;
+        std::string error;
+        CHECK(store.LoadShard(id, loaded, generation, error));
+        CHECK(loaded.empty());
+        CHECK(error.empty());
+    }
+
+    void TestCorruptIndexFallsBack()
+    {
+        TempDirectory dir;
+        {
+            PackShardStore store(dir.Path(), GENERATIONS);
+            std::string warning;
+            store.LoadIndex(warning);
+            PersistenceWriter writer("", GENERATIONS);
+            CHECK(SavePack(store, writer, "A", MakePack(1, 2)));
+            CHECK(SavePack(store, writer, "B", MakePack(1, 2)));
+        }
+        const std::string index = dir.File("index.txt");
+        const std::string intact = ReadWholeFile(index);
+        CHECK(intact.rfind("#ctindex 1 ", 0) == 0);
+
+        std::string flipped = intact;
+        flipped.back() ^= 0x01;
+        for (const std::string& damaged : { flipped, intact.substr(0, intact.size() - 1), std::string() }) {
+            WriteWholeFile(index, damaged);
+            PackShardStore store(dir.Path(), GENERATIONS);
+            std::string warning;
+            CHECK(store.LoadIndex(warning));
+            CHECK(warning.find("using generation 1") != std::string::npos);
+            // The recovered index is rewritten with the next save.
+            CHECK(store.IsIndexDirty());
+            PackId id = 0;
+            CHECK(store.Find("A", id) && id == 0);
+            CHECK(!store.Find("B", id));
+            // B's shard is still on disk, so its number is not handed out again.
+            CHECK(store.Intern("C") == 2);
+        }
+    }
+
+    void TestNoIndexNeverReusesShardNumbers()
+    {
+        TempDirectory dir;
+        SaveTwoVersions(dir);
+        WriteWholeFile(dir.File("7.hist"), "x");
+        for (int generation = 0; generation < GENERATIONS; ++generation) {
+            std::filesystem::remove(PersistenceWriter::GenerationPath(dir.File("index.txt"), generation));
+        }
+
+        PackShardStore store(dir.Path(), GENERATIONS);
+        std::string warning;
+        CHECK(!store.LoadIndex(warning));
+        CHECK(store.Intern("NEW") == 8);
+    }
+
+    void TestIndexWithoutHeaderAccepted()
+    {
+        TempDirectory dir;
+        WriteWholeFile(dir.File("index.txt"), "0|PACK\r\nbad line\n3|A|B\n");
+        PackShardStore store(dir.Path(), GENERATIONS);
+        std::string warning;
+        CHECK(store.LoadIndex(warning));
+        CHECK(warning.find("line 2") != std::string::npos);
+        PackId id = 0;
+        CHECK(store.Find("PACK", id) && id == 0);
+        CHECK(store.Find("A|B", id) && id == 3);
+        CHECK(store.Intern("NEW") == 4);
+        CHECK(store.IsIndexDirty());
+    }
+
+#ifndef _WIN32
+    // A child process saves ever newer versions of a large pack through PersistenceWriter while the parent
+    // SIGKILLs it at a different point in each round. Whatever the child was doing, the next load must find a
+    // complete snapshot: the last version the child reported as flushed, or the one it was writing.
+    void TestKillMidWrite()
+    {
+        TempDirectory dir;
+        int reported = 0;
+        for (int round = 0; round < 25; ++round) {
+            int pipe_fds[2];
+            CHECK(::pipe(pipe_fds) == 0);
+            const pid_t child = ::fork();
+            CHECK(child >= 0);
+            if (child == 0) {
+                ::close(pipe_fds[0]);
+                PackShardStore store(dir.Path(), GENERATIONS);
+                std::string warning;
+                store.LoadIndex(warning);
+                PersistenceWriter writer("", GENERATIONS);
+                for (int version = reported + 1;; ++version) {
+                    if (!SavePack(store, writer, "PACK", MakePack(version, MAX_SHOTS))) ::_exit(1);
+                    if (::write(pipe_fds[1], &version, sizeof(version)) != sizeof(version)) ::_exit(1);
+                }
+            }
+            ::close(pipe_fds[1]);
+
+            // Let it complete a couple of saves, then kill it somewhere inside a later one.
+            int version = 0;
+            for (int saves = 0; saves < 2 && ::read(pipe_fds[0], &version, sizeof(version)) == sizeof(version); ++saves) {
+                reported = version;
+            }
+            ::usleep(static_cast<useconds_t>((round * 173) % 1500));
+            ::kill(child, SIGKILL);
+            int status = 0;
+            ::waitpid(child, &status, 0);
+            CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+            while (::read(pipe_fds[0], &version, sizeof(version)) == sizeof(version)) {
+                reported = version;
+            }
+            ::close(pipe_fds[0]);
+
+            int generation = -1;
+            std::string error;
+            const int loaded = LoadPackVersion(dir, generation, error);
+            if (loaded != reported && loaded != reported + 1) {
+                std::fprintf(stderr, "round %d: loaded version %d (generation %d, %s), last flushed %d\n",
+                    round, loaded, generation, error.c_str(), reported);
+            }
+            CHECK(loaded == reported || loaded == reported + 1);
+            reported = loaded;
+        }
+    }
+#endif
+}
+
+int main()
+{
+    RUN_TEST(TestCurrentShardLoads);
+    RUN_TEST(TestTornShardFallsBack);
+    RUN_TEST(TestCorruptShardFallsBack);
+    RUN_TEST(TestMisnamedShardRejected);
+    RUN_TEST(TestUnsavedPackLoadsEmpty);
+    RUN_TEST(TestCorruptIndexFallsBack);
+    RUN_TEST(TestNoIndexNeverReusesShardNumbers);
+    RUN_TEST(TestIndexWithoutHeaderAccepted);
+#ifndef _WIN32
+    RUN_TEST(TestKillMidWrite);
+#endif
+    return TestResult();
+}
@@ -0,0 +1,114 @@
+// PackTable: colliding IDs, growth, lookups after a rehash, iteration, clear(), and that looking up an ID already
+// present never moves the table.
+
+#include "PackTable.h"
+#include "TestCheck.h"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // IDs that all start probing at the same slot of a table with `capacity` slots (as PackTable hashes them).
+    std::vector<PackId> CollidingIds(size_t capacity, size_t count)
+    {
+        std::vector<PackId> ids;
+        const size_t bucket = (static_cast<size_t>(1) * 0x9E3779B1u) & (capacity - 1);
+        for (PackId id = 1; ids.size() < count; ++id) {
+            if (((static_cast<size_t>(id) * 0x9E3779B1u) & (capacity - 1)) == bucket) ids.push_back(id);
+        }
+        return ids;
+    }
+
+    void TestCollisions()
+    {
+        PackTable<int> table;
+        const std::vector<PackId> ids = CollidingIds(16, 6);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            table[ids[i]] = static_cast<int>(i) + 100;
+        }
+        CHECK(table.size() == ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            CHECK(table.count(ids[i]) == 1);
+            CHECK(table.find(ids[i])->second == static_cast<int>(i) + 100);
+        }
+        // An absent ID whose probe runs through the whole cluster.
+        CHECK(table.count(CollidingIds(16, 7).back()) == 0);
+        CHECK(table.count(0) == 0);
+    }
+
+    void TestGrowthKeepsEntries()
+    {
+        PackTable<PackId> table;
+        for (PackId id = 0; id < 5000; ++id) {
+            table[id * 3] = id;
+            CHECK(table.size() == id + 1);
+        }
+        for (PackId id = 0; id < 5000; ++id) {
+            CHECK(table.count(id * 3) == 1 && table.find(id * 3)->second == id);
+            CHECK(table.count(id * 3 + 1) == 0);
+        }
+    }
+
+    void TestLookupOfPresentIdNeverRehashes()
+    {
+        // 12 entries in 16 slots: the next insert grows the table, a lookup must not.
+        PackTable<int> table;
+        for (PackId id = 0; id < 12; ++id) table[id] = static_cast<int>(id);
+        int* first = &table.find(0)->second;
+        for (PackId id = 0; id < 12; ++id) {
+            CHECK(table[id] == static_cast<int>(id));
+        }
+        CHECK(&table[0] == first);
+        CHECK(table.size() == 12);
+
+        table[12] = 12;
+        CHECK(table.size() == 13);
+        CHECK(table[0] == 0 && table[12] == 12);
+    }
+
+    void TestIterationVisitsEachEntryOnce()
+    {
+        PackTable<int> table;
+        CHECK(table.begin() == table.end());
+        std::vector<int> seen(200, 0);
+        for (PackId id = 0; id < 200; id += 2) table[id] = 1;
+        for (auto& pair : table) {
+            seen[pair.first] += pair.second;
+            pair.second = 2;
+        }
+        for (PackId id = 0; id < 200; ++id) {
+            CHECK(seen[id] == (id % 2 == 0 ? 1 : 0));
+        }
+        const PackTable<int>& const_table = table;
+        size_t visited = 0;
+        for (const auto& pair : const_table) {
+            CHECK(pair.second == 2);
+            visited++;
+        }
+        CHECK(visited == 100);
+    }
+
+    void TestClear()
+    {
+        PackTable<std::unique_ptr<int>> table; // Move-only values survive rehashing too
+        for (PackId id = 0; id < 40; ++id) table[id] = std::make_unique<int>(static_cast<int>(id));
+        CHECK(*table[39] == 39);
+        table.clear();
+        CHECK(table.empty());
+        CHECK(table.count(39) == 0);
+        CHECK(table.begin() == table.end());
+        CHECK(table[39] == nullptr);
+        CHECK(table.size() == 1);
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestCollisions);
+    RUN_TEST(TestGrowthKeepsEntries);
+    RUN_TEST(TestLookupOfPresentIdNeverRehashes);
+    RUN_TEST(TestIterationVisitsEachEntryOnce);
+    RUN_TEST(TestClear);
+    return TestResult();
+}
@@ -0,0 +1,341 @@
+// PersistenceWriter: a burst of saves to one path is one write of the latest snapshot, Flush and Stop write
+// everything queued, and a file is only ever replaced whole. Journal handling: entries queued before a save are held
+// until the snapshot that covers them is on disk, go back into the journal if any file of the save fails, and the
+// failed file is retried with the next save. The journal is only truncated once every file of the batch has been
+// renamed into place.
+
+#include "PersistenceWriter.h"
+#include "StatsTextFormat.h"
+#include "TempDirectory.h"
+#include "TestCheck.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // A snapshot whose serialization blocks the writer thread until released, so requests can be queued behind it.
+    class Gate
+    {
+    public:
+        PersistenceWriter::FileSnapshot Snapshot(const std::string& path, std::string* journal_seen = nullptr,
+            const std::string& journal_path = "")
+        {
+            return { path, [this, journal_seen, journal_path]() {
+                if (journal_seen) *journal_seen = ReadWholeFile(journal_path);
+                entered_.set_value();
+                released_.wait();
+                return std::string("gate");
+            } };
+        }
+        void WaitEntered() { entered_future_.wait(); }
+        void Release() { release_.set_value(); }
+
+    private:
+        std::promise<void> entered_;
+        std::future<void> entered_future_ = entered_.get_future();
+        std::promise<void> release_;
+        std::shared_future<void> released_ = release_.get_future().share();
+    };
+
+    PersistenceWriter::FileSnapshot Snapshot(const std::string& path, std::string contents)
+    {
+        return { path, [contents]() { return contents; } };
+    }
+
+    std::vector<PersistenceWriter::FileSnapshot> Files(PersistenceWriter::FileSnapshot file)
+    {
+        std::vector<PersistenceWriter::FileSnapshot> files;
+        files.push_back(std::move(file));
+        return files;
+    }
+
+    void TestBurstIsOneWriteOfLatestSnapshot()
+    {
+        TempDirectory dir;
+        const std::string path = dir.File("stats.bin");
+        PersistenceWriter writer("", 3);
+        Gate gate;
+        writer.RequestSave(Files(gate.Snapshot(dir.File("gate.bin"))));
+        gate.WaitEntered();
+
+        std::atomic<int> serialized{ 0 };
+        for (int version = 1; version <= 10; ++version) {
+            writer.RequestSave(Files({ path, [&serialized, version]() {
+                serialized++;
+                return "version " + std::to_string(version);
+            } }));
+        }
+        gate.Release();
+        CHECK(writer.Flush());
+
+        CHECK(serialized == 1);
+        CHECK(writer.GetWriteCount() == 2);
+        CHECK(ReadWholeFile(path) == "version 10");
+        // A second write would have kept the first as generation 1.
+        CHECK(!std::filesystem::exists(PersistenceWriter::GenerationPath(path, 1)));
+    }
+
+    void TestFlushWritesEverythingQueued()
+    {
+        TempDirectory dir;
+        PersistenceWriter writer(dir.File("journal.txt"));
+        Gate gate;
+        writer.RequestSave(Files(gate.Snapshot(dir.File("gate.bin"))));
+        gate.WaitEntered();
+        writer.RequestSave(Files(Snapshot(dir.File("stats.bin"), "stats")));
+        writer.RequestAppend("A;");
+        writer.RequestAppendTo(dir.File("0.hist"), "history");
+
+        std::thread releaser([&gate] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            gate.Release();
+        });
+        CHECK(writer.Flush());
+        releaser.join();
+
+        CHECK(ReadWholeFile(dir.File("gate.bin")) == "gate");
+        CHECK(ReadWholeFile(dir.File("stats.bin")) == "stats");
+        CHECK(ReadWholeFile(dir.File("journal.txt")) == "A;");
+        CHECK(ReadWholeFile(dir.File("0.hist")) == "history");
+    }
+
+    void TestStopWritesEverythingQueued()
+    {
+        // onUnload stops the writer without a Flush first.
+        TempDirectory dir;
+        PersistenceWriter writer(dir.File("journal.txt"));
+        Gate gate;
+        writer.RequestSave(Files(gate.Snapshot(dir.File("gate.bin"))));
+        gate.WaitEntered();
+        writer.RequestSave(Files(Snapshot(dir.File("stats.bin"), "stats")));
+        writer.RequestAppend("A;");
+        writer.RequestAppendTo(dir.File("0.hist"), "history");
+        gate.Release();
+        writer.Stop();
+
+        CHECK(ReadWholeFile(dir.File("stats.bin")) == "stats");
+        CHECK(ReadWholeFile(dir.File("journal.txt")) == "A;");
+        CHECK(ReadWholeFile(dir.File("0.hist")) == "history");
+
+        // Requests after Stop are ignored, and Stop and Flush still return.
+        writer.RequestSave(Files(Snapshot(dir.File("late.bin"), "late")));
+        writer.Stop();
+        writer.Flush();
+        CHECK(!std::filesystem::exists(dir.File("late.bin")));
+    }
+
+    void TestFailedSerializationKeepsOldFile()
+    {
+        TempDirectory dir;
+        const std::string path = dir.File("stats.bin");
+        PersistenceWriter writer("");
+        writer.RequestSave(Files(Snapshot(path, "old")));
+        CHECK(writer.Flush());
+        writer.RequestSave(Files({ path, []() -> std::string { throw std::runtime_error("out of memory"); } }));
+        CHECK(!writer.Flush());
+        CHECK(ReadWholeFile(path) == "old");
+    }
+
+#ifndef _WIN32
+    // A child saves ever newer versions of a 4 MiB file (every byte the version's letter) while the parent SIGKILLs
+    // it at a different point each round: the file is always some complete version, never a mix or a prefix.
+    void TestKilledWriterLeavesWholeFile()
+    {
+        TempDirectory dir;
+        const std::string path = dir.File("stats.bin");
+        constexpr size_t SIZE = 4 << 20;
+        for (int round = 0; round < 15; ++round) {
+            const pid_t child = ::fork();
+            CHECK(child >= 0);
+            if (child == 0) {
+                PersistenceWriter writer("");
+                for (int version = 0;; ++version) {
+                    writer.RequestSave(Files(Snapshot(path, std::string(SIZE, static_cast<char>('a' + version % 26)))));
+                    writer.Flush();
+                }
+            }
+            ::usleep(static_cast<useconds_t>(2000 + (round * 7919) % 40000));
+            ::kill(child, SIGKILL);
+            int status = 0;
+            ::waitpid(child, &status, 0);
+
+            if (!std::filesystem::exists(path)) continue; // Killed before the first rename
+            const std::string contents = ReadWholeFile(path);
+            CHECK(contents.size() == SIZE);
+            CHECK(contents.find_first_not_of(contents.front()) == std::string::npos);
+        }
+    }
+#endif
+
+    void TestAppendsHeldUntilSaveSucceeds()
+    {
+        TempDirectory dir;
+        const std::string journal = dir.File("journal.txt");
+        PersistenceWriter writer(journal);
+        writer.RequestAppend("A;");
+        CHECK(writer.Flush());
+        CHECK(ReadWholeFile(journal) == "A;");
+
+        // The gate's save covers "A;", but the journal keeps it while the gate's file is being written.
+        Gate gate;
+        std::string journal_during_gate;
+        writer.RequestSave(Files(gate.Snapshot(dir.File("gate.bin"), &journal_during_gate, journal)));
+        gate.WaitEntered();
+
+        // "B;" is queued before the next save and so belongs to it; "C;" comes after it.
+        std::string journal_during_save;
+        writer.RequestAppend("B;");
+        writer.RequestSave(Files({ dir.File("stats.bin"), [&]() {
+            journal_during_save = ReadWholeFile(journal);
+            return std::string("stats");
+        } }));
+        writer.RequestAppend("C;");
+        gate.Release();
+        CHECK(writer.Flush());
+
+        CHECK(journal_during_gate == "A;");
+        CHECK(journal_during_save.find("B;") == std::string::npos);
+        CHECK(ReadWholeFile(dir.File("stats.bin")) == "stats");
+        CHECK(ReadWholeFile(journal) == "C;");
+    }
+
+    void TestFailedSaveKeepsEntriesAndRetries()
+    {
+        TempDirectory dir;
+        const std::string journal = dir.File("journal.txt");
+        // A target whose parent directory is a regular file cannot be written.
+        const std::string blocker = dir.File("blocker");
+        WriteWholeFile(blocker, "not a directory");
+        const std::string unwritable = (std::filesystem::path(blocker) / "pack.bin").string();
+
+        PersistenceWriter writer(journal);
+        writer.RequestAppend("A;");
+        CHECK(writer.Flush());
+
+        writer.RequestAppend("B;");
+        std::vector<PersistenceWriter::FileSnapshot> files;
+        files.push_back(Snapshot(dir.File("good.bin"), "good"));
+        files.push_back(Snapshot(unwritable, "retried"));
+        writer.RequestSave(std::move(files));
+        CHECK(!writer.Flush());
+
+        // The other file was written, but the journal was not truncated: it still replays everything.
+        CHECK(ReadWholeFile(dir.File("good.bin")) == "good");
+        CHECK(ReadWholeFile(journal) == "A;B;");
+        CHECK(!writer.TakeMessages().empty());
+
+        // The next save (even one with no files of its own) retries the failed file, then truncates.
+        std::filesystem::remove(blocker);
+        std::filesystem::create_directory(blocker);
+        writer.RequestAppend("C;");
+        writer.RequestSave({});
+        CHECK(writer.Flush());
+        CHECK(ReadWholeFile(unwritable) == "retried");
+        CHECK(ReadWholeFile(journal).empty());
+    }
+
+    void TestFailedFileReplacedByNewerSnapshot()
+    {
+        TempDirectory dir;
+        const std::string blocker = dir.File("blocker");
+        WriteWholeFile(blocker, "not a directory");
+        const std::string path = (std::filesystem::path(blocker) / "pack.bin").string();
+
+        PersistenceWriter writer(dir.File("journal.txt"));
+        writer.RequestSave(Files(Snapshot(path, "old")));
+        CHECK(!writer.Flush());
+
+        std::filesystem::remove(blocker);
+        std::filesystem::create_directory(blocker);
+        writer.RequestSave(Files(Snapshot(path, "new")));
+        CHECK(writer.Flush());
+        CHECK(ReadWholeFile(path) == "new");
+    }
+
+    void TestTruncatedOnlyAfterEveryRename()
+    {
+        TempDirectory dir;
+        const std::string journal = dir.File("journal.txt");
+        PersistenceWriter writer(journal);
+        writer.RequestAppend("A;");
+        CHECK(writer.Flush());
+
+        // Files are written in path order; when the last one is serialized the first is already in place and the
+        // journal is still whole.
+        std::string journal_seen;
+        bool first_in_place = false;
+        std::vector<PersistenceWriter::FileSnapshot> files;
+        files.push_back(Snapshot(dir.File("a.bin"), "a"));
+        files.push_back({ dir.File("b.bin"), [&]() {
+            first_in_place = ReadWholeFile(dir.File("a.bin")) == "a";
+            journal_seen = ReadWholeFile(journal);
+            return std::string("b");
+        } });
+        writer.RequestSave(std::move(files));
+        CHECK(writer.Flush());
+        CHECK(first_in_place);
+        CHECK(journal_seen == "A;");
+        CHECK(ReadWholeFile(journal).empty());
+    }
+
+    void TestTornJournalEntrySkippedOnReplay()
+    {
+        TempDirectory dir;
+        const std::string journal = dir.File("journal.txt");
+        {
+            PersistenceWriter writer(journal);
+            ShotLifetimeStats s;
+            s.lifetime_best_successes = 4;
+            std::string entry;
+            AppendStatsRecord(entry, "P", 0, s);
+            AppendStatsRecord(entry, "P", 1, s);
+            writer.RequestAppend(entry);
+            CHECK(writer.Flush());
+        }
+        // A crash in the middle of the next append.
+        WriteWholeFile(journal, ReadWholeFile(journal) + "P|2|5|5|1");
+
+        StatsParseReport report;
+        const PersistentData replayed = DeserializeJournal(ReadWholeFile(journal), &report);
+        CHECK(report.records == 2);
+        CHECK(report.malformed_records == 0);
+        CHECK(replayed.at("P").size() == 2);
+        CHECK(replayed.at("P").at(1).lifetime_best_successes == 4);
+        CHECK(!replayed.at("P").count(2));
+
+        // Nothing complete at all.
+        CHECK(DeserializeJournal("P|0|1|1|1|1|1", &report).empty());
+        CHECK(report.records == 0);
+        CHECK(DeserializeJournal("").empty());
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestBurstIsOneWriteOfLatestSnapshot);
+    RUN_TEST(TestFlushWritesEverythingQueued);
+    RUN_TEST(TestStopWritesEverythingQueued);
+    RUN_TEST(TestFailedSerializationKeepsOldFile);
+#ifndef _WIN32
+    RUN_TEST(TestKilledWriterLeavesWholeFile);
+#endif
+    RUN_TEST(TestAppendsHeldUntilSaveSucceeds);
+    RUN_TEST(TestFailedSaveKeepsEntriesAndRetries);
+    RUN_TEST(TestFailedFileReplacedByNewerSnapshot);
+    RUN_TEST(TestTruncatedOnlyAfterEveryRename);
+    RUN_TEST(TestTornJournalEntrySkippedOnReplay);
+    return TestResult();
+}
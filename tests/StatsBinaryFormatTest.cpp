@@ -0,0 +1,111 @@
+// Binary stats format: Encode/Decode round trips, EncodePack against Encode, version 1 files, and rejection of
+// truncated or corrupted buffers.
+
+#include "StatsBinaryFormat.h"
+#include "StatsTestData.h"
+#include "StatsTextFormat.h"
+#include "TestCheck.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    bool DecodeString(const std::string& bytes, PersistentData& out, std::string& error)
+    {
+        return StatsBinary::Decode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), out, error);
+    }
+
+    void TestRoundTrip()
+    {
+        for (int packs : { 0, 1, 40 }) {
+            const PersistentData data = MakeStatsData(packs, 60, static_cast<uint32_t>(packs) + 3);
+            const std::string bytes = StatsBinary::Encode(data);
+            CHECK(StatsBinary::HasMagic(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+
+            PersistentData decoded;
+            std::string error;
+            CHECK(DecodeString(bytes, decoded, error));
+            CHECK(error.empty());
+            CHECK(SameStatsData(decoded, data));
+            CHECK(StatsBinary::Encode(decoded) == bytes);
+        }
+    }
+
+    void TestMatchesTextFormat()
+    {
+        // Both formats store boost as the same float, so converting through the text format changes nothing.
+        const PersistentData data = MakeStatsData(20, 30, 11);
+        CHECK(StatsBinary::Encode(DeserializeStats(SerializeStats(data))) == StatsBinary::Encode(data));
+
+        const std::string text = SerializeStats(data);
+        CHECK(!StatsBinary::HasMagic(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+    }
+
+    void TestEncodePackMatchesEncode()
+    {
+        const PersistentData data = MakeStatsData(1, 200, 5);
+        const auto& pack = *data.begin();
+        std::vector<StatsBinary::EncodedRecord> records;
+        for (const auto& shot_pair : pack.second) {
+            StatsBinary::EncodeRecord(records.emplace_back(), shot_pair.first, shot_pair.second);
+        }
+        CHECK(StatsBinary::EncodePack(pack.first, records) == StatsBinary::Encode(data));
+    }
+
+    void TestVersion1Readable()
+    {
+        // A version 1 file is the version 2 one with a 20 byte header: no checksum field.
+        const PersistentData data = MakeStatsData(3, 10, 9);
+        const std::string v2 = StatsBinary::Encode(data);
+        std::string v1 = v2.substr(0, StatsBinary::HEADER_SIZE_V1) + v2.substr(StatsBinary::HEADER_SIZE);
+        const uint16_t version = 1;
+        const uint16_t header_size = static_cast<uint16_t>(StatsBinary::HEADER_SIZE_V1);
+        std::memcpy(&v1[4], &version, sizeof(version));
+        std::memcpy(&v1[6], &header_size, sizeof(header_size));
+
+        PersistentData decoded;
+        std::string error;
+        CHECK(DecodeString(v1, decoded, error));
+        CHECK(SameStatsData(decoded, data));
+    }
+
+    void TestDamagedBuffersRejected()
+    {
+        const std::string bytes = StatsBinary::Encode(MakeStatsData(2, 5, 2));
+        PersistentData decoded;
+        std::string error;
+
+        for (size_t size = 0; size < bytes.size(); ++size) {
+            decoded.clear();
+            error.clear();
+            CHECK(!DecodeString(bytes.substr(0, size), decoded, error));
+            CHECK(!error.empty());
+        }
+
+        // Any single bit flip after the header fails the checksum.
+        for (size_t offset = StatsBinary::HEADER_SIZE; offset < bytes.size(); ++offset) {
+            std::string flipped = bytes;
+            flipped[offset] ^= 0x10;
+            decoded.clear();
+            CHECK(!DecodeString(flipped, decoded, error));
+        }
+
+        const uint16_t future_version = StatsBinary::VERSION + 1;
+        std::string future = bytes;
+        std::memcpy(&future[4], &future_version, sizeof(future_version));
+        CHECK(!DecodeString(future, decoded, error));
+        CHECK(error.find("version") != std::string::npos);
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestRoundTrip);
+    RUN_TEST(TestMatchesTextFormat);
+    RUN_TEST(TestEncodePackMatchesEncode);
+    RUN_TEST(TestVersion1Readable);
+    RUN_TEST(TestDamagedBuffersRejected);
+    return TestResult();
+}
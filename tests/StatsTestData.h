@@ -0,0 +1,54 @@
+#pragma once
+
+// Pseudo-random lifetime stats for the format round-trip tests, and a field-by-field comparison.
+
+#include "ShotStats.h"
+
+#include <cstdint>
+#include <string>
+
+// `packs` packs named "PACK-<n>" with `shots_per_pack` shots each (every third shot missing). Boost values cover
+// zero, small and large tick counts and the NO_BOOST_TICKS sentinel.
+inline PersistentData MakeStatsData(int packs, int shots_per_pack, uint32_t seed = 1)
+{
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % range;
+    };
+    auto boost = [&next]() -> BoostTicks {
+        switch (next(4)) {
+        case 0: return 0;
+        case 1: return next(1000);
+        case 2: return next(10000000);
+        default: return NO_BOOST_TICKS;
+        }
+    };
+
+    PersistentData data;
+    for (int pack = 0; pack < packs; ++pack) {
+        ShotPackStats& stats = data["PACK-" + std::to_string(pack)];
+        for (int shot_index = 0; shot_index < shots_per_pack; ++shot_index) {
+            if (shot_index % 3 == 2) continue;
+            ShotLifetimeStats& s = stats[shot_index];
+            s.lifetime_best_successes = static_cast<int>(next(100));
+            s.lifetime_attempts_at_best = static_cast<int>(next(100000));
+            s.lifetime_total_boost_ticks_at_best = boost();
+            s.lifetime_total_successful_boost_ticks_at_best = boost();
+            s.lifetime_min_boost_ticks = boost();
+        }
+    }
+    return data;
+}
+
+inline bool SameStatsData(const PersistentData& a, const PersistentData& b)
+{
+    if (a.size() != b.size()) return false;
+    for (const auto& pack_pair : a) {
+        auto other = b.find(pack_pair.first);
+        if (other == b.end() || other->second.size() != pack_pair.second.size()) return false;
+        for (const auto& shot_pair : pack_pair.second) {
+            if (!other->second.count(shot_pair.first) || other->second.at(shot_pair.first) != shot_pair.second) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,224 @@
+// Text stats format: DeserializeStats on well-formed, legacy and malformed input, and byte-for-byte round trips
+// through SerializeStats and WriteStats.
+
+#include "StatsTextFormat.h"
+#include "StatsTestData.h"
+#include "TempDirectory.h"
+#include "TestCheck.h"
+
+#include <fcntl.h>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const ShotLifetimeStats* Find(const PersistentData& data, const std::string& pack, int shot_index)
+    {
+        auto it = data.find(pack);
+        if (it == data.end() || !it->second.count(shot_index)) return nullptr;
+        return &it->second.at(shot_index);
+    }
+
+    void TestParsesRecords()
+    {
+        StatsParseReport report;
+        const PersistentData data = DeserializeStats("AAAA|0|3|5|27.777779|13.888889|5.5555553;AAAA|2|0|1|0|0|3.4028235e+38;B|1|1|1|1|1|1", &report);
+        CHECK(report.records == 3);
+        CHECK(report.malformed_records == 0);
+        CHECK(report.first_error.empty());
+        CHECK(data.size() == 2);
+
+        const ShotLifetimeStats* s = Find(data, "AAAA", 0);
+        CHECK(s != nullptr);
+        if (s) {
+            CHECK(s->lifetime_best_successes == 3);
+            CHECK(s->lifetime_attempts_at_best == 5);
+            CHECK(s->lifetime_total_boost_ticks_at_best == 100);
+            CHECK(s->lifetime_total_successful_boost_ticks_at_best == 50);
+            CHECK(s->lifetime_min_boost_ticks == 20);
+        }
+        s = Find(data, "AAAA", 2);
+        CHECK(s && s->lifetime_min_boost_ticks == NO_BOOST_TICKS);
+        CHECK(Find(data, "AAAA", 1) == nullptr);
+        s = Find(data, "B", 1);
+        CHECK(s && s->lifetime_total_boost_ticks_at_best == BoostAmountToTicks(1.0));
+    }
+
+    void TestEmptyInputAndEmptyRecords()
+    {
+        StatsParseReport report;
+        CHECK(DeserializeStats("", &report).empty());
+        CHECK(report.records == 0 && report.malformed_records == 0);
+
+        const PersistentData data = DeserializeStats(";;P|0|1|1|1|1|1;;;P|1|1|1|1|1|1;", &report);
+        CHECK(report.records == 2);
+        CHECK(report.malformed_records == 0);
+        CHECK(data.at("P").size() == 2);
+    }
+
+    void TestLegacySixSegmentRecords()
+    {
+        StatsParseReport report;
+        const PersistentData data = DeserializeStats("OLD|4|7|2.000000|1.000000|340282346638528859811704183484516925440.000000", &report);
+        CHECK(report.records == 1);
+        CHECK(report.legacy_records == 1);
+        const ShotLifetimeStats* s = Find(data, "OLD", 4);
+        CHECK(s != nullptr);
+        if (s) {
+            CHECK(s->lifetime_best_successes == 7);
+            CHECK(s->lifetime_attempts_at_best == 10);
+            CHECK(s->lifetime_total_boost_ticks_at_best == BoostAmountToTicks(2.0));
+            CHECK(s->lifetime_min_boost_ticks == NO_BOOST_TICKS);
+        }
+    }
+
+    void TestMalformedRecordsSkipped()
+    {
+        // Each bad record is skipped on its own; the good ones around it still load.
+        const char* bad_records[] = {
+            "P|2|1|1|1|1|1|1",           // 8 segments
+            "P|3|1|1|1",                 // 5 segments
+            "P|4|x|1|1|1|1",             // not a number
+            "P|5|12abc|1|1|1|1",         // trailing garbage
+            "P|6||1|1|1|1",              // empty field
+            "P|-1|1|1|1|1|1",            // negative shot index
+            "P|4096|1|1|1|1|1",          // shot index past MAX_SHOTS
+            "P|7|99999999999|1|1|1|1",   // does not fit an int
+            "P|8|1|1|1.5.5|1|1",         // two decimal points
+        };
+        std::string text = "P|0|1|1|1|1|1;P|1|1|1|1|1";
+        for (const char* record : bad_records) {
+            text += ';';
+            text += record;
+        }
+        text += ";P|9|1|1|1|1|1";
+
+        StatsParseReport report;
+        const PersistentData data = DeserializeStats(text, &report);
+        CHECK(report.records == 3);
+        CHECK(report.legacy_records == 1);
+        CHECK(report.malformed_records == 9);
+        CHECK(report.first_error == "record 3: unexpected segment count");
+
+        const ShotPackStats& pack = data.at("P");
+        CHECK(pack.size() == 3);
+        CHECK(pack.count(0) && pack.count(1) && pack.count(9));
+    }
+
+    void TestLaterRecordsOverwrite()
+    {
+        // Journal replay: the snapshot first, then the journal's newer records for the same shots.
+        const PersistentData data = DeserializeStats("A|0|1|1|1|1|1;B|0|2|2|2|2|2;A|0|5|6|1|1|1;A|1|1|1|1|1|1");
+        CHECK(data.at("A").size() == 2);
+        CHECK(data.at("A").at(0).lifetime_best_successes == 5);
+        CHECK(data.at("A").at(0).lifetime_attempts_at_best == 6);
+        CHECK(data.at("B").at(0).lifetime_best_successes == 2);
+    }
+
+    void TestPackIdsAreTakenVerbatim()
+    {
+        // Anything before the first '|' is the pack ID, including spaces and other separators.
+        const PersistentData data = DeserializeStats(" A-B C |0|1|1|1|1|1");
+        CHECK(data.count(" A-B C ") == 1);
+    }
+
+    void TestDamagedBoostValuesClamped()
+    {
+        const PersistentData data = DeserializeStats("P|0|1|1|-5|nan|inf");
+        // from_chars accepts "nan" and "inf": they read as 0 ticks and "no best yet", never as garbage.
+        const ShotLifetimeStats* s = Find(data, "P", 0);
+        CHECK(s != nullptr);
+        if (s) {
+            CHECK(s->lifetime_total_boost_ticks_at_best == 0);
+            CHECK(s->lifetime_total_successful_boost_ticks_at_best == 0);
+            CHECK(s->lifetime_min_boost_ticks == NO_BOOST_TICKS);
+        }
+    }
+
+    void TestRoundTrip()
+    {
+        for (int packs : { 0, 1, 40 }) {
+            const PersistentData data = MakeStatsData(packs, 60, static_cast<uint32_t>(packs));
+            const std::string text = SerializeStats(data);
+            StatsParseReport report;
+            const PersistentData parsed = DeserializeStats(text, &report);
+            CHECK(report.malformed_records == 0);
+            CHECK(SameStatsData(parsed, data));
+            CHECK(SerializeStats(parsed) == text);
+        }
+
+        // Past float precision the ticks no longer come back exactly, but the text written from them still does.
+        PersistentData data;
+        ShotLifetimeStats& s = data["P"][MAX_SHOTS - 1];
+        s.lifetime_total_boost_ticks_at_best = NO_BOOST_TICKS - 1;
+        s.lifetime_total_successful_boost_ticks_at_best = 1;
+        const std::string text = SerializeStats(data);
+        const PersistentData parsed = DeserializeStats(text);
+        CHECK(SerializeStats(parsed) == text);
+        CHECK(parsed.at("P").at(MAX_SHOTS - 1).lifetime_min_boost_ticks == NO_BOOST_TICKS);
+        CHECK(parsed.at("P").at(MAX_SHOTS - 1).lifetime_total_boost_ticks_at_best != NO_BOOST_TICKS);
+    }
+
+    void TestRecordTerminators()
+    {
+        ShotLifetimeStats s;
+        s.lifetime_best_successes = 2;
+        s.lifetime_attempts_at_best = 3;
+        const std::string record = SerializeStatsRecord("P", 4, s);
+        CHECK(record == "P|4|2|3|0|0|3.4028235e+38");
+
+        std::string appended = "X;";
+        AppendStatsRecord(appended, "P", 4, s);
+        CHECK(appended == "X;" + record + ";");
+    }
+
+    std::string WriteStatsToFile(const TempDirectory& dir, const PersistentData& data, bool& ok)
+    {
+        const std::string path = dir.File("stats.txt");
+#ifdef _WIN32
+        const int fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+        ok = fd >= 0 && WriteStats(fd, data);
+        if (fd >= 0) ::_close(fd);
+#else
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ok = fd >= 0 && WriteStats(fd, data);
+        if (fd >= 0) ::close(fd);
+#endif
+        return ReadWholeFile(path);
+    }
+
+    void TestWriteStatsMatchesSerializeStats()
+    {
+        TempDirectory dir;
+        // Empty, well under one 64 KiB chunk, and several chunks with long pack names to move the chunk boundaries.
+        for (int packs : { 0, 1, 300 }) {
+            PersistentData data = MakeStatsData(packs, 100, static_cast<uint32_t>(packs) + 7);
+            if (packs > 1) data[std::string(500, 'L')] = data.begin()->second;
+            bool ok = false;
+            const std::string written = WriteStatsToFile(dir, data, ok);
+            CHECK(ok);
+            CHECK(written == SerializeStats(data));
+            if (packs == 300) CHECK(written.size() > 4 * 64 * 1024);
+        }
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestParsesRecords);
+    RUN_TEST(TestEmptyInputAndEmptyRecords);
+    RUN_TEST(TestLegacySixSegmentRecords);
+    RUN_TEST(TestMalformedRecordsSkipped);
+    RUN_TEST(TestLaterRecordsOverwrite);
+    RUN_TEST(TestPackIdsAreTakenVerbatim);
+    RUN_TEST(TestDamagedBoostValuesClamped);
+    RUN_TEST(TestRoundTrip);
+    RUN_TEST(TestRecordTerminators);
+    RUN_TEST(TestWriteStatsMatchesSerializeStats);
+    return TestResult();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// A fresh directory under the system temp directory, removed with everything in it when the test is done.
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+
+class TempDirectory
+{
+public:
+    TempDirectory()
+    {
+        std::random_device random;
+        std::error_code ec;
+        do {
+            path_ = std::filesystem::temp_directory_path() / ("ct_test_" + std::to_string(random()));
+        } while (!std::filesystem::create_directory(path_, ec) && !ec);
+    }
+    ~TempDirectory()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    std::string Path() const { return path_.string(); }
+    std::string File(const std::string& name) const { return (path_ / name).string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+inline std::string ReadWholeFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+inline void WriteWholeFile(const std::string& path, const std::string& contents)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
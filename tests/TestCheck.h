@@ -0,0 +1,29 @@
+#pragma once
+
+// Minimal checks for the core tests: a failed CHECK prints where and what, and the test keeps going so one run
+// reports every failure. main() returns TestResult().
+
+#include <cstdio>
+
+inline int g_test_failures = 0;
+
+#define CHECK(condition)                                                                          \
+    do {                                                                                          \
+        if (!(condition)) {                                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);    \
+            g_test_failures++;                                                                    \
+        }                                                                                         \
+    } while (0)
+
+// Runs one test function and names it in the output.
+#define RUN_TEST(test)                      \
+    do {                                    \
+        std::printf("%s\n", #test);         \
+        test();                             \
+    } while (0)
+
+inline int TestResult()
+{
+    if (g_test_failures > 0) std::fprintf(stderr, "%d check(s) failed\n", g_test_failures);
+    return g_test_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,291 @@
+// TrainerCore state machine, driven through StandInTrainerHost the way the plugin's event handlers drive it.
+
+#include "TrainerCore.h"
+#include "StandInTrainerHost.h"
+#include "TestCheck.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = TrainerCore::Clock;
+    using State = TrainerCore::AttemptState;
+
+    // Also records the order of the host calls that matter for sequencing.
+    class RecordingHost : public StandInTrainerHost
+    {
+    public:
+        void RepeatCurrentShot() override
+        {
+            StandInTrainerHost::RepeatCurrentShot();
+            calls.push_back("repeat");
+        }
+        void RecordAttempt(const AttemptHistory::AttemptRecord& record) override
+        {
+            StandInTrainerHost::RecordAttempt(record);
+            calls.push_back("record");
+        }
+        void CommitLifetime(int shot_index, const ShotLifetimeStats& lifetime) override
+        {
+            StandInTrainerHost::CommitLifetime(shot_index, lifetime);
+            calls.push_back("commit " + std::to_string(shot_index));
+        }
+
+        std::vector<std::string> calls;
+    };
+
+    struct Fixture
+    {
+        explicit Fixture(int shot_count = 3, int shot_index = 0)
+        {
+            core.BindPack(&pack, shot_count, shot_index);
+        }
+        ~Fixture() { DrainLogTo(nullptr); }
+
+        RecordingHost host;
+        TrainerCore core{ host };
+        ShotPackStats pack;
+        Clock::time_point now = Clock::now();
+    };
+
+    void TestSuccessRecordsBoostBetweenStartAndOutcome()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 100);
+        CHECK(f.core.State() == State::Live);
+        CHECK(f.core.AttemptBoostTicks(130) == 30);
+
+        f.core.OnOutcome(true, f.now + std::chrono::milliseconds(1500), 148);
+        CHECK(f.core.State() == State::Settled);
+        CHECK(f.core.AttemptBoostTicks(200) == 0);
+
+        const ShotSessionStats& stats = f.core.Stats().Session(0);
+        CHECK(stats.attempts == 1);
+        CHECK(stats.successes == 1);
+        CHECK(stats.total_boost_ticks == 48);
+        CHECK(stats.min_successful_boost_ticks == 48);
+
+        CHECK(f.host.attempts.size() == 1);
+        CHECK(f.host.attempts[0].success);
+        CHECK(f.host.attempts[0].duration_ms == 1500);
+        CHECK(f.host.attempts[0].boost_used == static_cast<float>(BoostTicksToAmount(48)));
+    }
+
+    void TestBoostTotalMayWrap()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0xFFFFFFF0u);
+        f.core.OnOutcome(false, f.now, 0x10u);
+        CHECK(f.core.Stats().Session(0).total_boost_ticks == 0x20u);
+    }
+
+    void TestLifetimeBestUpdatedOnSettle()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0);
+        // The run length is raised as soon as the attempt starts...
+        CHECK(f.pack.at(0).lifetime_attempts_at_best == 1);
+        CHECK(f.pack.at(0).lifetime_best_successes == 0);
+
+        // ...and the rest when it settles, straight into the bound pack.
+        f.core.OnOutcome(true, f.now, 40);
+        const ShotLifetimeStats& lifetime = f.pack.at(0);
+        CHECK(lifetime.lifetime_best_successes == 1);
+        CHECK(lifetime.lifetime_attempts_at_best == 1);
+        CHECK(lifetime.lifetime_min_boost_ticks == 40);
+        CHECK(lifetime.lifetime_total_boost_ticks_at_best == 40);
+        CHECK(lifetime.lifetime_total_successful_boost_ticks_at_best == 40);
+        CHECK(f.core.Stats().TakeLifetimeChanged(0));
+        CHECK(!f.core.Stats().TakeLifetimeChanged(0));
+
+        std::string expected;
+        AppendStatsRecord(expected, "STANDIN", 0, lifetime);
+        CHECK(f.host.journal == expected);
+    }
+
+    void TestSameSuccessesWithLessBoostWinsTieBreak()
+    {
+        ShotLifetimeStats lifetime;
+        lifetime.lifetime_best_successes = 2;
+        lifetime.lifetime_attempts_at_best = 3;
+        lifetime.lifetime_total_boost_ticks_at_best = 300;
+
+        ShotSessionStats run;
+        run.attempts = 3;
+        run.successes = 2;
+        run.total_boost_ticks = 250;
+        run.total_successful_boost_ticks = 200;
+        CHECK(TrainerCore::UpdateLifetimeBest(0, run, lifetime));
+        CHECK(lifetime.lifetime_total_boost_ticks_at_best == 250);
+
+        run.total_boost_ticks = 260;
+        CHECK(!TrainerCore::UpdateLifetimeBest(0, run, lifetime));
+        DrainLogTo(nullptr);
+    }
+
+    void TestDuplicateOutcomeDropped()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0);
+        f.core.OnOutcome(true, f.now, 10);
+        // A goal is followed by the ball exploding.
+        f.core.OnOutcome(false, f.now, 12);
+        CHECK(f.core.DuplicateOutcomes() == 1);
+        CHECK(f.host.attempts.size() == 1);
+        CHECK(f.core.Stats().Session(0).attempts == 1);
+        CHECK(f.core.Stats().Session(0).successes == 1);
+
+        // Outcomes before any attempt are dropped as well.
+        Fixture idle;
+        idle.core.OnOutcome(true, idle.now, 0);
+        CHECK(idle.core.DuplicateOutcomes() == 1);
+        CHECK(idle.host.attempts.empty());
+    }
+
+    void TestRepeatCurrentShotOrdering()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0);
+        f.core.OnOutcome(false, f.now, 5);
+        // The attempt is persisted before the shot is put back.
+        const std::vector<std::string> expected = { "record", "commit 0", "repeat" };
+        CHECK(f.host.calls == expected);
+        CHECK(f.host.shots_repeated == 1);
+        CHECK(f.core.ExpectsSelfReset());
+    }
+
+    void TestSelfResetAbsorbedExactlyOnce()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0);
+        f.core.OnOutcome(true, f.now, 5);
+
+        // The game delivers our reset only after the next attempt has started: that attempt must stay live.
+        f.core.OnShotAttempt(f.now, 5);
+        f.core.OnShotReset(f.now, 6);
+        CHECK(f.core.State() == State::Live);
+        CHECK(f.core.SelfResets() == 1);
+        CHECK(!f.core.ExpectsSelfReset());
+
+        // A second reset is the player's, and fails the attempt.
+        f.core.OnShotReset(f.now, 9);
+        CHECK(f.host.attempts.size() == 2);
+        CHECK(!f.host.attempts[1].success);
+        CHECK(f.core.Stats().Session(0).total_boost_ticks == 5 + 4);
+
+        // In the usual order the reset arrives while the attempt is settled.
+        f.core.OnShotReset(f.now, 9);
+        CHECK(f.core.SelfResets() == 2);
+        CHECK(f.core.DuplicateOutcomes() == 0);
+    }
+
+    void TestShotChangeDropsExpectedSelfReset()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0);
+        f.core.OnOutcome(true, f.now, 5);
+        f.core.OnShotChanged(1, 3);
+        CHECK(!f.core.ExpectsSelfReset());
+        CHECK(f.core.State() == State::Idle);
+
+        f.core.OnShotAttempt(f.now, 5);
+        f.core.OnShotReset(f.now, 7);
+        CHECK(f.host.attempts.size() == 2);
+        CHECK(f.host.attempts[1].shot_index == 1);
+    }
+
+    void TestShotChangeCommitsAndAbandonsAttempt()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0);
+        f.host.calls.clear();
+        f.core.OnShotChanged(2, 3);
+        CHECK(f.core.CurrentShot() == 2);
+        CHECK(f.core.State() == State::Idle);
+        const std::vector<std::string> expected = { "commit 0" };
+        CHECK(f.host.calls == expected);
+
+        // The abandoned attempt's outcome must not land on the new shot.
+        f.core.OnOutcome(true, f.now, 10);
+        CHECK(f.host.attempts.empty());
+        CHECK(f.core.DuplicateOutcomes() == 1);
+    }
+
+    void TestOutOfRangeShotIndex()
+    {
+        // The game's index wraps around at either end of the pack.
+        Fixture f(5, 0);
+        f.core.OnShotChanged(5, 5);
+        CHECK(f.core.CurrentShot() == 0);
+        f.core.OnShotChanged(-1, 5);
+        CHECK(f.core.CurrentShot() == 4);
+
+        // Without a shot count there is nothing to wrap against; an index the tables cannot hold is ignored.
+        Fixture unknown(0, 0);
+        unknown.core.OnShotChanged(MAX_SHOTS, 0);
+        CHECK(unknown.core.CurrentShot() == MAX_SHOTS);
+        CHECK(unknown.core.IsShotFrozen());
+        unknown.core.OnShotAttempt(unknown.now, 0);
+        CHECK(unknown.core.State() == State::Idle);
+        unknown.core.OnOutcome(true, unknown.now, 0);
+        CHECK(unknown.host.attempts.empty());
+
+        // An index past the bound shot count but still valid is added on its first attempt.
+        Fixture grows(2, 0);
+        grows.core.OnShotChanged(7, 0);
+        grows.core.OnShotAttempt(grows.now, 0);
+        CHECK(grows.core.Stats().Contains(7));
+        CHECK(grows.core.Stats().Session(7).attempts == 1);
+        CHECK(grows.pack.count(7) == 1);
+    }
+
+    void TestMaxAttemptsEndsRunAndRepeats()
+    {
+        Fixture f;
+        f.core.SetMaxAttemptsPerShot(2);
+        f.core.OnShotAttempt(f.now, 0);
+        f.core.OnOutcome(true, f.now, 10);
+        CHECK(!f.core.IsShotFrozen());
+        f.core.OnShotAttempt(f.now, 10);
+        CHECK(f.core.IsShotFrozen());
+        f.core.OnOutcome(true, f.now, 30);
+
+        // The finished run is folded into the lifetime bests, then the session counters start over.
+        CHECK(f.pack.at(0).lifetime_best_successes == 2);
+        CHECK(f.pack.at(0).lifetime_attempts_at_best == 2);
+        CHECK(f.pack.at(0).lifetime_min_boost_ticks == 10);
+        CHECK(f.core.Stats().Session(0).attempts == 0);
+        CHECK(!f.core.IsShotFrozen());
+        CHECK(f.host.shots_repeated == 2);
+    }
+
+    void TestResetSessionKeepsLifetime()
+    {
+        Fixture f;
+        f.core.OnShotAttempt(f.now, 0);
+        f.core.OnOutcome(true, f.now, 10);
+        f.core.ResetSession();
+        CHECK(f.core.State() == State::Idle);
+        CHECK(!f.core.ExpectsSelfReset());
+        CHECK(f.core.Stats().Session(0).attempts == 0);
+        CHECK(f.pack.at(0).lifetime_best_successes == 1);
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestSuccessRecordsBoostBetweenStartAndOutcome);
+    RUN_TEST(TestBoostTotalMayWrap);
+    RUN_TEST(TestLifetimeBestUpdatedOnSettle);
+    RUN_TEST(TestSameSuccessesWithLessBoostWinsTieBreak);
+    RUN_TEST(TestDuplicateOutcomeDropped);
+    RUN_TEST(TestRepeatCurrentShotOrdering);
+    RUN_TEST(TestSelfResetAbsorbedExactlyOnce);
+    RUN_TEST(TestShotChangeDropsExpectedSelfReset);
+    RUN_TEST(TestShotChangeCommitsAndAbandonsAttempt);
+    RUN_TEST(TestOutOfRangeShotIndex);
+    RUN_TEST(TestMaxAttemptsEndsRunAndRepeats);
+    RUN_TEST(TestResetSessionKeepsLifetime);
+    return TestResult();
+}